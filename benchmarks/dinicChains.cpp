@@ -0,0 +1,130 @@
+#include "src/DinicLinkCut.h"
+#include "src/PushRelabel.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+/**
+ * @brief Times Dinic with link-cut trees against Edmonds Karp (FlowCore::maxFlow) and push-relabel on the deep
+ * synthetic networks DinicLinkCut is meant for, all on one thread. The networks come from a fixed seed, so every run
+ * solves the same ones.
+ *
+ * Usage: dinicChains [chainLength chains fanChainLength fanWidth seed], by default 2000 20 100000 5000 11.
+ */
+
+/**
+ * @brief Parallel chains of equal length from the source to the sink, with random capacities and a cross link from a
+ * quarter of the vertices to the next level of a random chain, so the level graphs are as deep as the chains
+ *
+ * Complexity: O(chains * length)
+ *
+ * @param length : Vertices per chain
+ * @param chains : Number of chains
+ * @param rng : Random numbers
+ * @return Network, with no flow
+ */
+static FlowCore<int64_t> crossLinkedChains(int length, int chains, mt19937 &rng) {
+    FlowCore<int64_t> net;
+    for (int i = 0; i < chains * length + 2; i++) net.addVertex();
+    FlowId s = chains * length, t = chains * length + 1;
+    net.setTerminals(s, t);
+    for (int k = 0; k < chains; k++) {
+        net.addArc(s, k * length, 1000);
+        net.addArc(k * length + length - 1, t, 1000);
+        for (int i = 0; i + 1 < length; i++) {
+            net.addArc(k * length + i, k * length + i + 1, 1 + rng() % 100);
+            if (rng() % 4 == 0) net.addArc(k * length + i, (FlowId) (rng() % chains) * length + i + 1, 1 + rng() % 50);
+        }
+    }
+    return net;
+}
+
+/**
+ * @brief One long chain of unbounded capacity feeding a wide fan-out to the sink, so every augmenting path shares the
+ * whole chain
+ *
+ * Complexity: O(length + width)
+ *
+ * @param length : Vertices of the chain
+ * @param width : Branches of the fan-out
+ * @param rng : Random numbers
+ * @return Network, with no flow
+ */
+static FlowCore<int64_t> chainWithFanOut(int length, int width, mt19937 &rng) {
+    const int64_t UNBOUNDED = 1000000000;
+    FlowCore<int64_t> net;
+    for (int i = 0; i < length + width + 2; i++) net.addVertex();
+    FlowId s = length + width, t = length + width + 1;
+    net.setTerminals(s, t);
+    net.addArc(s, 0, UNBOUNDED);
+    for (int i = 0; i + 1 < length; i++) net.addArc(i, i + 1, UNBOUNDED);
+    for (int j = 0; j < width; j++) {
+        net.addArc(length - 1, length + j, 1 + rng() % 10);
+        net.addArc(length + j, t, 1 + rng() % 10);
+    }
+    return net;
+}
+
+/**
+ * @brief Get the time taken by a function
+ *
+ * Complexity: O(f)
+ *
+ * @param f : Function
+ * @return Milliseconds
+ */
+template <class F>
+static double millis(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Solves a network with the three solvers and prints their max flow and time
+ *
+ * Complexity: O(solves)
+ *
+ * @param name : Name of the network
+ * @param net : Network, with no flow
+ * @return True if the three max flows agree
+ */
+static bool compare(const string &name, const FlowCore<int64_t> &net) {
+    FlowCore<int64_t> byEdmondsKarp = net, byDinic = net, byPushRelabel = net;
+    DinicLinkCut<int64_t> dinic(byDinic);
+    int64_t edmondsKarp = 0, linkCut = 0, pushRelabel = 0;
+    double edmondsKarpMs = millis([&] { edmondsKarp = byEdmondsKarp.maxFlow(); });
+    double linkCutMs = millis([&] { linkCut = dinic.solve(); });
+    double pushRelabelMs = millis([&] { pushRelabel = PushRelabel<int64_t>(byPushRelabel, 1).solve(); });
+
+    cout << name << ": " << net.numVertices() << " vertices, " << net.numArcs() / 2 << " arcs" << endl;
+    cout << "    edmondsKarp   " << edmondsKarp << " in " << edmondsKarpMs << " ms" << endl;
+    cout << "    dinicLinkCut  " << linkCut << " in " << linkCutMs << " ms (" << dinic.getPhases() << " phases)" << endl;
+    cout << "    pushRelabel   " << pushRelabel << " in " << pushRelabelMs << " ms" << endl;
+    if (linkCut != edmondsKarp || pushRelabel != edmondsKarp) {
+        cerr << "Error: " << name << ": the max flows differ" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    int chainLength = argc > 1 ? atoi(argv[1]) : 2000;
+    int chains = argc > 2 ? atoi(argv[2]) : 20;
+    int fanChainLength = argc > 3 ? atoi(argv[3]) : 100000;
+    int fanWidth = argc > 4 ? atoi(argv[4]) : 5000;
+    unsigned seed = argc > 5 ? (unsigned) atoi(argv[5]) : 11;
+    if (chainLength < 1 || chains < 1 || fanChainLength < 1 || fanWidth < 1) {
+        cerr << "Error: sizes must be positive." << endl;
+        return 1;
+    }
+
+    mt19937 rng(seed);
+    bool agree = compare(to_string(chains) + " cross-linked chains of " + to_string(chainLength),
+                         crossLinkedChains(chainLength, chains, rng));
+    agree = compare("chain of " + to_string(fanChainLength) + " with a fan-out of " + to_string(fanWidth),
+                    chainWithFanOut(fanChainLength, fanWidth, rng)) && agree;
+    return agree ? 0 : 1;
+}
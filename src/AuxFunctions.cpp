@@ -1,42 +1,76 @@
 #include "AuxFunctions.h"
+#include "ResultCache.h"
+#include "SolverTuner.h"
+#include "NetworkStats.h"
+#include "FlowDecomposition.h"
 #include <cmath>
 
 vector<vector<string>> AuxFunctions::maxWaterPerCity;
+SearchState AuxFunctions::search;
 
 AuxFunctions::AuxFunctions() = default;
 
-void AuxFunctions::testAndVisit(std::queue<Vertex*> &q, Edge* e, Vertex* w, double residual) {
-    if (!w->isVisited() && residual > 0) {
-        w->setVisited(true);
-        w->setPath(e);
+void AuxFunctions::testAndVisit(std::queue<Vertex*> &q, Edge* e, Vertex* w, double residual, SearchState &state) {
+    if (!state.isVisited(w) && residual > 0) {
+        state.setVisited(w);
+        state.setPath(w, e);
         q.push(w);
     }
 }
 
-bool AuxFunctions::findAugmentingPaths(Vertex* s, Vertex* t) {
-    for(Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        v->setVisited(false);
+void AuxFunctions::testAndReach(std::queue<Vertex*> &q, Edge* e, Vertex* w, double residual, SearchState &state) {
+    if (!state.isReached(w) && residual > 0) {
+        state.setReached(w, e);
+        q.push(w);
     }
-    s->setVisited(true);
-    std::queue<Vertex*> q;
-    q.push(s);
-    while(!q.empty() && !t->isVisited()) {
-        auto v = q.front();
-        q.pop();
-        for(Edge* e: v->getAdj()) {
-            testAndVisit(q, e, e->getDest(), e->getWeight() - e->getFlow());
-        }
-        for(Edge* e: v->getIncoming()) {
-            testAndVisit(q, e, e->getOrig(), e->getFlow());
+}
+
+bool AuxFunctions::findAugmentingPaths(Vertex* s, Vertex* t, SearchState &state) {
+    state.begin(csvInfo::pipesGraph);
+    state.setVisited(s);
+    state.setReached(t, nullptr);
+    std::queue<Vertex*> fromSource, fromTarget;
+    fromSource.push(s);
+    fromTarget.push(t);
+
+    // one whole level at a time, from the smaller side, so the first vertex both sides share is on a shortest path
+    Vertex* meet = nullptr;
+    while (meet == nullptr && !fromSource.empty() && !fromTarget.empty()) {
+        bool forward = fromSource.size() <= fromTarget.size();
+        std::queue<Vertex*> &q = forward ? fromSource : fromTarget;
+        for (size_t level = q.size(); level > 0 && meet == nullptr; level--) {
+            auto v = q.front();
+            q.pop();
+            for (Edge* e: v->getAdj()) {
+                Vertex* w = e->getDest();
+                if (forward) testAndVisit(q, e, w, e->getWeight() - e->getFlow(), state);
+                else testAndReach(q, e, w, e->getFlow(), state);
+                if (state.isVisited(w) && state.isReached(w)) meet = w;
+            }
+            for (Edge* e: v->getIncoming()) {
+                Vertex* w = e->getOrig();
+                if (forward) testAndVisit(q, e, w, e->getFlow(), state);
+                else testAndReach(q, e, w, e->getWeight() - e->getFlow(), state);
+                if (state.isVisited(w) && state.isReached(w)) meet = w;
+            }
         }
     }
-    return t->isVisited();
+    if (meet == nullptr) return false;
+
+    // hand the target half over to the path, as if it had been found from the source
+    for (Vertex* v = meet; v != t;) {
+        Edge* e = state.getToward(v);
+        Vertex* w = e->getOrig() == v ? e->getDest() : e->getOrig();
+        state.setPath(w, e);
+        v = w;
+    }
+    return true;
 }
 
-double AuxFunctions::findMinResidualAlongPath(Vertex* s, Vertex* t) {
+double AuxFunctions::findMinResidualAlongPath(Vertex* s, Vertex* t, SearchState &state) {
     double f = INF;
     for (Vertex* v = t; v != s;) {
-        Edge* e = v->getPath();
+        Edge* e = state.getPath(v);
         if (e->getDest() == v) {
             f = std::min(f, e->getWeight() - e->getFlow());
             v = e->getOrig();
@@ -49,10 +83,10 @@ double AuxFunctions::findMinResidualAlongPath(Vertex* s, Vertex* t) {
     return f;
 }
 
-void AuxFunctions::augmentFlowAlongPath(Vertex* s, Vertex* t) {
-    double f = findMinResidualAlongPath(s, t);
+void AuxFunctions::augmentFlowAlongPath(Vertex* s, Vertex* t, SearchState &state) {
+    double f = findMinResidualAlongPath(s, t, state);
     for (Vertex* v = t; v != s;) {
-        Edge* e = v->getPath();
+        Edge* e = state.getPath(v);
         double flow = e->getFlow();
         if (e->getDest() == v) {
             e->setFlow(std::min(flow + f, e->getWeight()));
@@ -83,7 +117,7 @@ void AuxFunctions::MaxWaterCity() {
 
     AuxFunctions::edmondsKarp("super_source", "super_sink");
 
-    for (auto & idx : csvInfo::citiesVector) {
+    for (City idx : csvInfo::citiesVector) {
         Vertex* s = csvInfo::pipesGraph.findVertex(idx.getCode());
         double flow = s->getAdj()[0]->getFlow();
         aux.clear();
@@ -95,29 +129,47 @@ void AuxFunctions::MaxWaterCity() {
 }
 
 void AuxFunctions::MaxFlow(bool csv) {
-    maxWaterPerCity.clear();
-
-    // add super sink
-    csvInfo::pipesGraph.addVertex("super_sink", -1, -1);
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        if (v->getType() == 0) {
-            csvInfo::pipesGraph.addEdge(v->getInfo(), "super_sink", csvInfo::citiesVector[v->getPos()].getDemand() * 1.0);
+    uint64_t key = ResultCache::hashPipesGraph();
+    vector<double> flows;
+    if (ResultCache::findMaxFlow(key, maxWaterPerCity, flows)) {
+        int i = 0;
+        for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
+            for (Edge* e : v->getAdj()) {
+                e->setFlow(flows[i++]);
+            }
         }
+        if (csv) csvInfo::writeToMaxWaterPerCity(maxWaterPerCity);
+        return;
     }
 
-    // add super source
-    csvInfo::pipesGraph.addVertex("super_source", -1, -1);
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        if (v->getType() == 1) {
-            csvInfo::pipesGraph.addEdge("super_source", v->getInfo(), csvInfo::reservoirsVector[v->getPos()].getMaxDelivery() * 1.0);
-        }
+    // solved by the engine SolverTuner chose for this network, then copied to the pipes
+    FlowNetwork net = FlowNetwork::fromPipesGraph();
+    SolverTuner::solveExact(net);
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        if (net.getEdge(a) != nullptr) net.getEdge(a)->setFlow(net.getFlow(a));
     }
 
-    AuxFunctions::MaxWaterCity();
+    setWaterPerCity(net.getCityFlows());
     if (csv) csvInfo::writeToMaxWaterPerCity(maxWaterPerCity);
 
-    csvInfo::pipesGraph.removeVertex("super_sink");
-    csvInfo::pipesGraph.removeVertex("super_source");
+    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
+        for (Edge* e : v->getAdj()) {
+            flows.push_back(e->getFlow());
+        }
+    }
+    ResultCache::storeMaxFlow(key, maxWaterPerCity, flows);
+}
+
+void AuxFunctions::setWaterPerCity(const vector<double> &cityFlows) {
+    maxWaterPerCity.clear();
+    vector<string> aux;
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        aux.clear();
+        aux.push_back(csvInfo::citiesVector[i].getCity());
+        aux.push_back(csvInfo::citiesVector[i].getCode());
+        aux.push_back(std::to_string(static_cast<long long>(std::round(cityFlows[i]))));
+        maxWaterPerCity.push_back(aux);
+    }
 }
 
 void AuxFunctions::simulateReservoirRemoval(const std::string& reservoirCode) {
@@ -147,188 +199,80 @@ void AuxFunctions::simulatePumpingStationRemoval(const string& code){
     }
 }
 
-void AuxFunctions::simulatePipelineFailure(Edge* e){
-    e->setWeight(0);
-
-    MaxFlow(false);
-
-    e->setWeight(e->getCapacity());
-}
-
-void AuxFunctions:: testAndVisit_ReservoirRemovalPart(std::queue<Vertex*> &q, Edge* e, Vertex* w, double flow) {
-    if (!w->isVisited() && flow > 0) {
-        w->setVisited(true);
-        w->setPath(e);
-        q.push(w);
-    }
-}
-
-bool AuxFunctions::findAugmentingPaths_ReservoirRemovalPart(Vertex* s, Vertex* t, bool residual) {
-    for(Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        v->setVisited(false);
-    }
-    if (residual) {
-        if ((s->getIncoming()[0]->getWeight() - s->getIncoming()[0]->getFlow() == 0) ||
-            (t->getAdj()[0]->getWeight() - t->getAdj()[0]->getFlow() == 0)) {
-            return false;
-        }
-    }
-    else {
-        if ((s->getIncoming()[0]->getFlow() == 0) || (t->getAdj()[0]->getFlow() == 0)) {
-            return false;
-        }
+bool AuxFunctions::screenPumpingStationRemoval(const string& code, const FlowNetwork &baseline, const DominatorTree &dominators) {
+    FlowId s = baseline.findVertex(code);
+    if (s == NO_ID) return false;
+    double through = 0;
+    for (FlowId a = baseline.firstArc(s); a != NO_ID; a = baseline.nextArc(a)) {
+        if (baseline.isPipe(a)) through += baseline.getFlow(a);
     }
-    s->setVisited(true);
-    std::queue<Vertex*> q;
-    q.push(s);
-    while(!q.empty() && !t->isVisited()) {
-        auto v = q.front();
-        q.pop();
-        for(Edge* e: v->getAdj()) {
-            if (residual) testAndVisit(q, e, e->getDest(), e->getWeight() - e->getFlow());
-            else testAndVisit_ReservoirRemovalPart(q, e, e->getDest(), e->getFlow());
-        }
+    if (through <= FlowCore<double>::epsilon()) {
+        setWaterPerCity(baseline.getCityFlows());
+        return true;
     }
-    return t->isVisited();
-}
 
-double AuxFunctions::findMinflow(Vertex *r, Vertex *c) {
-    Vertex* current = c;
-    double m = INF;
-    while (current != r) {
-        Edge* e = current->getPath();
-        if (e->getFlow() < m) m = e->getFlow();
-        current = e->getOrig();
+    double dominated = 0;
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        FlowId a = baseline.getCityArc(i);
+        if (a != NO_ID && dominators.dominates(s, baseline.getTail(a))) dominated += baseline.getFlow(a);
     }
-    m = min(r->getIncoming()[0]->getFlow(), m);
-    m = min(c->getAdj()[0]->getFlow(), m);
-    return m;
-}
+    if (std::abs(through - dominated) > FlowCore<double>::epsilon()) return false;    // some of it goes on elsewhere
 
-void AuxFunctions::removeFlow(Vertex* r, Vertex* sink) {
-    Vertex* current = sink;
-    double f = findMinflow(r, sink);
-    while (current != r) {
-        Edge* e = current->getPath();
-        e->setFlow(max(e->getFlow() - f, 0.0));
-        current = e->getOrig();
+    // only the cities s dominates lose water: drain it, then check nothing else can take it
+    FlowNetwork drained = baseline;
+    for (FlowId a = drained.firstArc(s); a != NO_ID; a = drained.nextArc(a)) {
+        if (drained.isPipe(a)) drained.setCapacity(a, 0);
     }
-    r->getIncoming()[0]->setFlow(r->getIncoming()[0]->getFlow() - f);
-    sink->getAdj()[0]->setFlow(sink->getAdj()[0]->getFlow() - f);
+    if (drained.getSourceSide()[drained.getSink()]) return false;
+    setWaterPerCity(drained.getCityFlows());
+    return true;
 }
 
-void AuxFunctions::simulateReservoirRemovalPart(const string& code) {
-    maxWaterPerCity.clear();
-
-    // add super sink
-    csvInfo::pipesGraph.addVertex("super_sink", -1, -1);
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        if (v->getType() == 0) {
-            csvInfo::pipesGraph.addEdge(v->getInfo(), "super_sink", csvInfo::citiesVector[v->getPos()].getDemand() * 1.0);
-        }
-    }
-
-    // add super source
-    csvInfo::pipesGraph.addVertex("super_source", -1, -1);
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        if (v->getType() == 1) {
-            csvInfo::pipesGraph.addEdge("super_source", v->getInfo(), csvInfo::reservoirsVector[v->getPos()].getMaxDelivery() * 1.0);
-        }
-    }
-    Vertex* super_source = csvInfo::pipesGraph.findVertex("super_source");
-    Vertex* super_sink = csvInfo::pipesGraph.findVertex("super_sink");
-
-    AuxFunctions::MaxWaterCity();
+void AuxFunctions::simulatePipelineFailure(Edge* e){
+    e->setWeight(0);
 
-    set<string> affected;
-    Vertex* r = csvInfo::pipesGraph.findVertex(code);
-    for (City c : csvInfo::citiesVector) {
-        Vertex* sink = csvInfo::pipesGraph.findVertex(c.getCode());
-        while (findAugmentingPaths_ReservoirRemovalPart(r, sink, false)) {
-            affected.insert(c.getCode());
-            removeFlow(r, sink);
-        }
-    }
+    MaxFlow(false);
 
-    for (Reservoir rev : csvInfo::reservoirsVector) {
-        Vertex* reservoir = csvInfo::pipesGraph.findVertex(rev.getCode());
-        if (rev.getCode() != code) {
-            for (const string& c : affected) {
-                Vertex* city = csvInfo::pipesGraph.findVertex(c);
-                while (findAugmentingPaths_ReservoirRemovalPart(reservoir, city, true)) {
-                    reservoir->setPath(reservoir->getIncoming()[0]);
-                    super_sink->setPath(city->getAdj()[0]);
-                    augmentFlowAlongPath(super_source, super_sink);
-                }
-            }
-        }
-    }
+    e->setWeight(e->getCapacity());
+}
 
-    // restore graph's weights
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        for (Edge *e: v->getAdj()) {
-            e->setWeight(e->getCapacity());
+void AuxFunctions::simulateReservoirRemovalPart(const string& code) {
+    shared_ptr<const FlowNetwork> solved;
+    shared_ptr<const FlowDecomposition> decomposition = ResultCache::solvedDecomposition(solved);
+    const FlowDecomposition &d = *decomposition;
+    FlowNetwork net(*solved);
+    FlowId reservoir = net.findVertex(code);
+    int pos = csvInfo::pipesGraph.findVertex(code)->getPos();
+
+    // take out the paths of the reservoir, found through the paths crossing the pipes leaving it
+    vector<bool> affected(csvInfo::citiesVector.size(), false);
+    for (FlowId a = net.firstArc(reservoir); a != NO_ID; a = net.nextArc(a)) {
+        if (!net.isPipe(a)) continue;
+        for (const int* p = d.arcPathsBegin(a); p != d.arcPathsEnd(a); p++) {
+            if (d.getPathReservoir(*p) != pos) continue;
+            double f = d.getPathFlow(*p);
+            int c = d.getPathCity(*p);
+            for (const FlowId* b = d.pathBegin(*p); b != d.pathEnd(*p); b++) net.setFlow(*b, net.getFlow(*b) - f);
+            net.setFlow(net.getReservoirArc(pos), net.getFlow(net.getReservoirArc(pos)) - f);
+            net.setFlow(net.getCityArc(c), net.getFlow(net.getCityArc(c)) - f);
+            affected[c] = true;
         }
     }
+    net.setCapacity(net.getReservoirArc(pos), 0);
 
-    maxWaterPerCity.clear();
-    vector<string> aux;
-    for (auto & idx : csvInfo::citiesVector) {
-        Vertex* s = csvInfo::pipesGraph.findVertex(idx.getCode());
-        double flow = 0;
-        for (Edge* e : s->getIncoming()) flow += e->getFlow();
-        aux.clear();
-        aux.push_back(idx.getCity());
-        aux.push_back(idx.getCode());
-        aux.push_back(std::to_string(static_cast<long long>(std::round(flow))));
-        maxWaterPerCity.push_back(aux);
+    // only the cities that lost water get more: the others keep exactly what they had
+    for (int c = 0; c < (int) csvInfo::citiesVector.size(); c++) {
+        if (!affected[c]) net.setCapacity(net.getCityArc(c), net.getFlow(net.getCityArc(c)));
     }
+    net.maxFlow();
 
-    csvInfo::pipesGraph.removeVertex("super_sink");
-    csvInfo::pipesGraph.removeVertex("super_source");
+    setWaterPerCity(net.getCityFlows());
 }
 
 
 
 vector<double> AuxFunctions::compute_metrics() {
-    double num = 0.0;
-    double sum = 0.0;
-    double max = 0.0;
-    double aux;
-    double maxFlow = 0.0;
-
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        if (v->getType() == 0) {
-            for (Edge* e : v->getIncoming()) {
-                maxFlow += e->getFlow();
-            }
-        }
-    }
-
-
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        for (Edge* e : v->getAdj()) {
-            if (e->getFlow() == 0 & e->getReverse() != nullptr) continue;
-            aux = e->getWeight() - e->getFlow();
-            sum += aux;
-            num++;
-            if (aux > max) max = aux;
-        }
-    }
-
-    double avg = sum * 1.0 / num;
-    double var_diff = 0;
-    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        for (Edge* e : v->getAdj()) {
-            if (e->getFlow() == 0 & e->getReverse() != nullptr) continue;
-            var_diff += pow(e->getWeight() - e->getFlow() - avg, 2);
-        }
-    }
-    var_diff /= num;
-
-    vector<double> metrics;
-    metrics = {maxFlow, avg, var_diff, max};
-    return metrics;
+    return NetworkStats::fromPipesGraph().getMetrics();
 }
 
 void AuxFunctions::print_metrics(vector<double> i, vector<double> f) {
@@ -337,36 +281,37 @@ void AuxFunctions::print_metrics(vector<double> i, vector<double> f) {
     cout << "average:  " << i[1] << " >> " << f[1] << endl;
     cout << "variance: " << i[2] << " >> " << f[2] << endl;
     cout << "max diff: " << i[3] << " >> " << f[3] << endl;
+    cout << "median:   " << i[4] << " >> " << f[4] << endl;
+    cout << "p90:      " << i[5] << " >> " << f[5] << endl;
+    cout << "p99:      " << i[6] << " >> " << f[6] << endl;
 }
 
-bool AuxFunctions::findAugmentingPaths_balance(Vertex* s, Vertex* t, double delta) {
-    for(Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
-        v->setVisited(false);
-    }
-    s->setVisited(true);
+bool AuxFunctions::findAugmentingPaths_balance(Vertex* s, Vertex* t, double delta, SearchState &state) {
+    state.begin(csvInfo::pipesGraph);
+    state.setVisited(s);
     std::queue<Vertex*> q;
     q.push(s);
-    while(!q.empty() && !t->isVisited()) {
+    while(!q.empty() && !state.isVisited(t)) {
         auto v = q.front();
         q.pop();
         for(Edge* e: v->getAdj()) {
             if (e->getWeight() - e->getFlow() >= delta) {
-                testAndVisit(q, e, e->getDest(), e->getWeight() - e->getFlow());
+                testAndVisit(q, e, e->getDest(), e->getWeight() - e->getFlow(), state);
             }
         }
         for (Edge* e: v->getIncoming()) {
             if (e->getWeight() - e->getFlow() >= delta) {
-                testAndVisit(q, e, e->getOrig(), e->getFlow());
+                testAndVisit(q, e, e->getOrig(), e->getFlow(), state);
             }
         }
     }
-    return t->isVisited();
+    return state.isVisited(t);
 }
 
-void AuxFunctions::augmentFlowAlongPath_CS(Vertex* s, Vertex* t) {
-    double f = findMinResidualAlongPath(s, t);
+void AuxFunctions::augmentFlowAlongPath_CS(Vertex* s, Vertex* t, SearchState &state) {
+    double f = findMinResidualAlongPath(s, t, state);
     for (Vertex* v = t; v != s;) {
-        Edge* e = v->getPath();
+        Edge* e = state.getPath(v);
         double flow = e->getFlow();
         if (e->getDest() == v) {
             e->setFlow(std::min(flow + f, e->getWeight()));
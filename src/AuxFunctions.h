@@ -2,6 +2,7 @@
 #define DA2324_PRJ1_G13_4_AUXFUNCTIONS_H
 
 #include "csvInfo.h"
+#include "DominatorTree.h"
 
 /**
  * @brief Auxiliar Functions
@@ -15,6 +16,11 @@ public:
      */
     static vector<vector<string>> maxWaterPerCity;
 
+    /**
+     * @brief Search state used by the augmenting path functions when none is given
+     */
+    static SearchState search;
+
     /**
      * @brief Default constructor
      *
@@ -31,19 +37,35 @@ public:
      * @param e : Edge
      * @param w : Vertex
      * @param residual : Flow or the difference between the weigh and the flow of an edge
+     * @param state : Search state
+     */
+    static void testAndVisit(std::queue<Vertex *> &q, Edge *e, Vertex *w, double residual, SearchState &state = search);
+
+    /**
+     * @brief Test if vertex was reached from the target and reach it if not
+     *
+     * Complexity: O(1)
+     *
+     * @param q : Queue of vertex
+     * @param e : Edge from w towards the target
+     * @param w : Vertex
+     * @param residual : Flow or the difference between the weigh and the flow of an edge
+     * @param state : Search state
      */
-    static void testAndVisit(std::queue<Vertex *> &q, Edge *e, Vertex *w, double residual);
+    static void testAndReach(std::queue<Vertex *> &q, Edge *e, Vertex *w, double residual, SearchState &state = search);
 
     /**
-     * @brief Find augmenting paths in a graph from a given source vertex to a target vertex
+     * @brief Find a shortest augmenting path from a given source vertex to a target vertex, searching from both ends
+     * at once
      *
      * Complexity: O(n^2)
      *
      * @param s : Source vertex
      * @param t : Target vertex
+     * @param state : Search state
      * @return True or false
      */
-    static bool findAugmentingPaths(Vertex *s, Vertex *t);
+    static bool findAugmentingPaths(Vertex *s, Vertex *t, SearchState &state = search);
 
     /**
      * @brief Calculates the minimum residual capacity along a path from source vertex s to target vertex t in a graph
@@ -52,9 +74,10 @@ public:
      *
      * @param s : Source vertex
      * @param t : Target vertex
+     * @param state : Search state holding the path
      * @return Double with the minimum residual capacity along the path
      */
-    static double findMinResidualAlongPath(Vertex *s, Vertex *t);
+    static double findMinResidualAlongPath(Vertex *s, Vertex *t, SearchState &state = search);
 
     /**
      * @brief Augments the flow along a path from source vertex s to target vertex t in a graph by the minimum residual capacity
@@ -63,8 +86,9 @@ public:
      *
      * @param s : Source vertex
      * @param t : Target vertex
+     * @param state : Search state holding the path
      */
-    static void augmentFlowAlongPath(Vertex *s, Vertex *t);
+    static void augmentFlowAlongPath(Vertex *s, Vertex *t, SearchState &state = search);
 
     /**
      * @brief Edmonds Karp algorithm
@@ -84,12 +108,25 @@ public:
     static void MaxWaterCity();
 
     /**
-     * @brief Calculate Max Flow
+     * @brief Calculate Max Flow with the engine SolverTuner chose for the network, and copy it to the pipes of
+     * pipesGraph. Results are cached by network state, so repeating it on an unchanged network only restores the
+     * cached flows.
      *
-     * Complexity: O(n^3)
+     * Complexity: O(n^3), O(n^2) if cached
+     *
+     * @param csv : Write the result to maxWaterPerCity.csv
      */
     static void MaxFlow(bool csv);
 
+    /**
+     * @brief Fills maxWaterPerCity with the water of each city
+     *
+     * Complexity: O(n)
+     *
+     * @param cityFlows : Water reaching each city, indexed like citiesVector
+     */
+    static void setWaterPerCity(const vector<double> &cityFlows);
+
     /**
      * @brief Simulate reservoir removal
      *
@@ -109,72 +146,44 @@ public:
     static void simulatePumpingStationRemoval(const string& code);
 
     /**
-     * @brief Simulate pipeline failure
-     *
-     * Complexity: O(n^3)
-     *
-     * @param e : Pipeline edge
-     */
-    static void simulatePipelineFailure(Edge *e);
-
-    /**
-     * @brief Testes if the vertex w is not visited and the flow is more that 0 and then visits the vertex and adds the edge e
-     *
-     * Complexity: O(1)
-     *
-     * @param q : Queue of vertex's
-     * @param e : Edge
-     * @param w : Vertex
-     * @param flow : Flow
-     */
-    static void testAndVisit_ReservoirRemovalPart(std::queue<Vertex*> &q, Edge* e, Vertex* w, double flow);
-
-    /**
-     * @brief Find augmenting paths
-     *
-     * Complexity: O(n^2)
-     *
-     * @param s : Source vertex
-     * @param t : Destination vertex
-     * @param residual : Path that already has flow or not
-     * @return True or false
-     */
-    static bool findAugmentingPaths_ReservoirRemovalPart(Vertex* s, Vertex* t, bool residual);
-
-    /**
-     * @brief Find the minimum flow starting in vertex r and ending in vertex c
+     * @brief Works out the removal of a pumping station from the solved network, without solving it again, when the
+     * dominator tree shows the outcome. A station carrying no water changes nothing. A station whose water all goes to
+     * cities it dominates (they get it through no other station) cuts exactly those cities off, as long as the water it
+     * no longer takes can not reach another city (no augmenting path once its flow is drained).
      *
-     * Complexity; O(n)
+     * Complexity: O(V + E)
      *
-     * @param r : Origin vertex
-     * @param c : Destination vertex
-     * @return Minimum flow
+     * @param code : Pumping station code
+     * @param baseline : Network of ResultCache::solvedNetwork()
+     * @param dominators : Dominator tree of baseline
+     * @return True if maxWaterPerCity now holds the water of each city without the station, false if it needs a re-solve
      */
-    static double findMinflow(Vertex *r, Vertex *c);
+    static bool screenPumpingStationRemoval(const string& code, const FlowNetwork &baseline, const DominatorTree &dominators);
 
     /**
-     * @brief Remove flow
+     * @brief Simulate pipeline failure
      *
-     * Complexity: O(n)
+     * Complexity: O(n^3)
      *
-     * @param r : Vertex
-     * @param sink : Sink vertex
+     * @param e : Pipeline edge
      */
-    static void removeFlow(Vertex* r, Vertex* sink);
+    static void simulatePipelineFailure(Edge *e);
 
     /**
-     * @brief Simulate reservoir removal
+     * @brief Simulate reservoir removal, refilling only the cities it supplied. The water of the reservoir is taken out
+     * along its paths of the cached flow decomposition (ResultCache::solvedDecomposition), and the max flow is re-run
+     * from what is left, with the other cities held at the water they already get. Fills maxWaterPerCity.
      *
-     * Complexity: O(n^3)
+     * Complexity: O(P + k (V + E)), P = arcs of the reservoir's paths, k = augmenting paths (O(V E^2) in the worst case)
      *
      * @param code : Reservoir code
      */
     static void simulateReservoirRemovalPart(const string& code);
 
     /**
-     * @brief Compute the metrics to calculate balance network
+     * @brief Compute the metrics to calculate balance network (see NetworkStats::getMetrics)
      *
-     * Complexity: O(n^2)
+     * Complexity: O(V + E)
      *
      * @return Metrics vector
      */
@@ -197,9 +206,10 @@ public:
      * @param s : Source vertex
      * @param t : Destination vertex
      * @param delta : Delta
+     * @param state : Search state
      * @return True or false
      */
-    static bool findAugmentingPaths_balance(Vertex* s, Vertex* t, double delta);
+    static bool findAugmentingPaths_balance(Vertex* s, Vertex* t, double delta, SearchState &state = search);
 
     /**
      * @brief Augments the flow along a path from source vertex s to target vertex t in a graph by the minimum residual
@@ -209,8 +219,9 @@ public:
      *
      * @param s : Source vertex
      * @param t : Target vertex
+     * @param state : Search state holding the path
      */
-    static void augmentFlowAlongPath_CS(Vertex* s, Vertex* t);
+    static void augmentFlowAlongPath_CS(Vertex* s, Vertex* t, SearchState &state = search);
 
     /**
      * @brief Balance Network
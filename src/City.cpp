@@ -1,31 +1,74 @@
 #include "City.h"
 
-#include <utility>
-
-City::City(string ct, int i, string c, double d, int p) {
-    city = std::move(ct);
-    Id = i;
-    code = std::move(c);
-    demand = d;
-    population = p;
+City::City(const CityTable *t, size_t r) {
+    table = t;
+    row = r;
 }
 
-string City::getCity() {
-    return city;
+const string &City::getCity() const {
+    return table->pool->get(table->names[row]);
 }
 
 int City::getId() const {
-    return Id;
+    return table->ids[row];
 }
 
-string City::getCode() {
-    return code;
+const string &City::getCode() const {
+    return table->pool->get(table->codes[row]);
 }
 
 double City::getDemand() const {
-    return demand;
+    return table->demands[row];
 }
 
 int City::getPopulation() const {
-    return population;
+    return table->populations[row];
+}
+
+CityTable::CityTable(StringPool &p) {
+    pool = &p;
+}
+
+void CityTable::add(const string &ct, int i, const string &c, double d, int p) {
+    names.push_back(pool->intern(ct));
+    ids.push_back(i);
+    codes.push_back(pool->intern(c));
+    demands.push_back(d);
+    populations.push_back(p);
+}
+
+void CityTable::clear() {
+    names.clear();
+    ids.clear();
+    codes.clear();
+    demands.clear();
+    populations.clear();
+}
+
+size_t CityTable::size() const {
+    return ids.size();
+}
+
+bool CityTable::empty() const {
+    return ids.empty();
+}
+
+City CityTable::operator[](size_t i) const {
+    return City(this, i);
+}
+
+CityTable::iterator CityTable::begin() const {
+    return iterator(this, 0);
+}
+
+CityTable::iterator CityTable::end() const {
+    return iterator(this, size());
+}
+
+const vector<double> &CityTable::getDemands() const {
+    return demands;
+}
+
+const vector<int> &CityTable::getPopulations() const {
+    return populations;
 }
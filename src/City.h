@@ -2,30 +2,29 @@
 #define DA2324_PRJ1_G13_4_CITY_H
 
 #include <string>
+#include <vector>
+#include "EntityIterator.h"
+#include "StringPool.h"
 using namespace std;
 
+class CityTable;
+
 /**
- * @brief Represents a City
+ * @brief Represents a City (a view of one row of a CityTable, cheap to copy)
  */
 class City {
 private:
-    string city;
-    int Id;
-    string code;
-    double demand;
-    int population;
+    const CityTable *table;
+    size_t row;
 public:
 
     /**
      * @brief Constructor of the City class
      *
-     * @param ct : City´s name
-     * @param i : Id
-     * @param c : Code
-     * @param d : Demand
-     * @param p : Population
+     * @param t : Table of the City
+     * @param r : Row of the City in the table
      */
-    City(string ct, int i, string c, double d, int p);
+    City(const CityTable *t, size_t r);
 
     /**
      * @brief Get the name of the City
@@ -34,7 +33,7 @@ public:
      *
      * @return Returns the value of the City's name
      */
-    string getCity();
+    const string &getCity() const;
 
     /**
      * @brief Get the Id of the City
@@ -52,7 +51,7 @@ public:
      *
      * @return Returns the value of the City's code
      */
-    string getCode();
+    const string &getCode() const;
 
     /**
      * @brief Get the demand of the City
@@ -73,5 +72,101 @@ public:
     int getPopulation() const;
 };
 
+/**
+ * @brief All the cities, one column per field, with names and codes interned in a StringPool.
+ *
+ * A scan over one field (e.g. the demands) reads that column only.
+ */
+class CityTable {
+public:
+    typedef EntityIterator<CityTable, City> iterator;
+
+    /**
+     * @brief Constructor of the CityTable class
+     *
+     * @param p : Pool of the names and codes (must outlive the table)
+     */
+    explicit CityTable(StringPool &p);
+
+    /**
+     * @brief Adds a City at the end of the table
+     *
+     * Complexity: O(|ct| + |c|) amortized
+     *
+     * @param ct : City´s name
+     * @param i : Id
+     * @param c : Code
+     * @param d : Demand
+     * @param p : Population
+     */
+    void add(const string &ct, int i, const string &c, double d, int p);
+
+    /**
+     * @brief Removes every City (the interned strings stay in the pool)
+     *
+     * Complexity: O(1)
+     */
+    void clear();
+
+    /**
+     * @brief Get number of cities
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of cities
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check if there are no cities
+     *
+     * Complexity: O(1)
+     *
+     * @return True or false
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get a City by its row
+     *
+     * Complexity: O(1)
+     *
+     * @param i : Row
+     * @return City
+     */
+    City operator[](size_t i) const;
+
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+     * @brief Get the demand of every City, by row
+     *
+     * Complexity: O(1)
+     *
+     * @return Demands
+     */
+    const vector<double> &getDemands() const;
+
+    /**
+     * @brief Get the population of every City, by row
+     *
+     * Complexity: O(1)
+     *
+     * @return Populations
+     */
+    const vector<int> &getPopulations() const;
+
+private:
+    friend class City;
+
+    StringPool *pool;
+    vector<StringId> names;
+    vector<int> ids;
+    vector<StringId> codes;
+    vector<double> demands;
+    vector<int> populations;
+};
+
 
 #endif //DA2324_PRJ1_G13_4_CITY_H
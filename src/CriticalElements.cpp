@@ -0,0 +1,132 @@
+#include "CriticalElements.h"
+#include "csvInfo.h"
+#include <algorithm>
+#include <functional>
+
+CriticalElements CriticalElements::fromPipesGraph() {
+    CriticalElements result;
+    const vector<Vertex *> &vertices = csvInfo::pipesGraph.getVertexSet();
+    int n = (int) vertices.size();
+    int root = n;
+
+    // undirected edges: the root to each reservoir (no pipe), then one per pipe
+    vector<int> ends;
+    vector<const Edge *> pipes;
+    for (Vertex *v : vertices) {
+        if (v->getType() == 1 && csvInfo::reservoirsVector[v->getPos()].getMaxDelivery() > 0) {
+            ends.push_back(root);
+            ends.push_back(v->getIndex());
+            pipes.push_back(nullptr);
+        }
+        if (v->getType() < 0) continue;
+        for (Edge *e : v->getAdj()) {
+            if (e->getDest()->getType() < 0 || e->getCapacity() <= 0) continue;
+            if (e->getReverse() != nullptr && less<const Edge *>()(e->getReverse(), e)) continue;    // other half taken
+            ends.push_back(v->getIndex());
+            ends.push_back(e->getDest()->getIndex());
+            pipes.push_back(e);
+        }
+    }
+    vector<int> adjStart(n + 2, 0), adjTo(ends.size()), adjEdge(ends.size());
+    for (int x : ends) adjStart[x + 1]++;
+    for (int v = 0; v <= n; v++) adjStart[v + 1] += adjStart[v];
+    vector<int> position(adjStart.begin(), adjStart.end() - 1);
+    for (size_t i = 0; i < ends.size(); i++) {
+        int x = ends[i], y = ends[i ^ 1];
+        adjTo[position[x]] = y;
+        adjEdge[position[x]++] = (int) (i / 2);
+    }
+
+    // lowpoint DFS from the root
+    vector<int> order(n + 1, -1), low(n + 1), parentEdge(n + 1, -1);
+    vector<pair<int, int>> stack = {{root, adjStart[root]}};
+    int counter = 0;
+    order[root] = low[root] = counter++;
+    result.subtreeEnd.assign(n + 1, 0);
+    while (!stack.empty()) {
+        int v = stack.back().first;
+        int &i = stack.back().second;
+        if (i < adjStart[v + 1]) {
+            int w = adjTo[i], id = adjEdge[i];
+            i++;
+            if (id == parentEdge[v]) continue;
+            if (order[w] >= 0) {
+                low[v] = min(low[v], order[w]);
+                continue;
+            }
+            order[w] = low[w] = counter++;
+            parentEdge[w] = id;
+            stack.emplace_back(w, adjStart[w]);
+            continue;
+        }
+        stack.pop_back();
+        result.subtreeEnd[order[v]] = counter;
+        if (stack.empty()) break;
+
+        int p = stack.back().first;
+        low[p] = min(low[p], low[v]);
+        if (low[v] > order[p] && pipes[parentEdge[v]] != nullptr) {
+            // only the direction of the pipe leading into the subtree brings it water
+            const Edge *e = pipes[parentEdge[v]];
+            if (e->getDest() == vertices[v]) result.pipeCuts[e] = order[v];
+            else if (e->getReverse() != nullptr) result.pipeCuts[e->getReverse()] = order[v];
+        }
+        if (low[v] >= order[p] && p != root && vertices[p]->getType() == 2) result.stationCuts[vertices[p]].push_back(order[v]);
+    }
+
+    // cities by preorder, so that those of a subtree are a range
+    vector<pair<int, string>> cities;
+    for (Vertex *v : vertices) {
+        if (v->getType() == 0 && order[v->getIndex()] >= 0) cities.emplace_back(order[v->getIndex()], v->getInfo());
+    }
+    sort(cities.begin(), cities.end());
+    for (auto &c : cities) {
+        result.cityOrder.push_back(c.first);
+        result.cityCodes.push_back(c.second);
+    }
+
+    // keep the cuts that leave some city without water
+    auto hasCity = [&](int subtree) {
+        auto it = lower_bound(result.cityOrder.begin(), result.cityOrder.end(), subtree);
+        return it != result.cityOrder.end() && *it < result.subtreeEnd[subtree];
+    };
+    for (auto it = result.pipeCuts.begin(); it != result.pipeCuts.end();) {
+        if (hasCity(it->second)) it++;
+        else it = result.pipeCuts.erase(it);
+    }
+    for (auto it = result.stationCuts.begin(); it != result.stationCuts.end();) {
+        vector<int> &subtrees = it->second;
+        subtrees.erase(remove_if(subtrees.begin(), subtrees.end(), [&](int s) { return !hasCity(s); }), subtrees.end());
+        if (subtrees.empty()) it = result.stationCuts.erase(it);
+        else it++;
+    }
+    return result;
+}
+
+void CriticalElements::addCities(int root, vector<string> &cities) const {
+    auto it = lower_bound(cityOrder.begin(), cityOrder.end(), root);
+    for (; it != cityOrder.end() && *it < subtreeEnd[root]; it++) cities.push_back(cityCodes[it - cityOrder.begin()]);
+}
+
+vector<string> CriticalElements::getCutOffCities(const Edge *e) const {
+    vector<string> cities;
+    auto it = pipeCuts.find(e);
+    if (it != pipeCuts.end()) addCities(it->second, cities);
+    return cities;
+}
+
+vector<string> CriticalElements::getCutOffCities(const Vertex *v) const {
+    vector<string> cities;
+    auto it = stationCuts.find(v);
+    if (it == stationCuts.end()) return cities;
+    for (int subtree : it->second) addCities(subtree, cities);
+    return cities;
+}
+
+int CriticalElements::numCriticalPipes() const {
+    return (int) pipeCuts.size();
+}
+
+int CriticalElements::numCriticalStations() const {
+    return (int) stationCuts.size();
+}
@@ -0,0 +1,84 @@
+#ifndef DA2324_PRJ1_G13_4_CRITICALELEMENTS_H
+#define DA2324_PRJ1_G13_4_CRITICALELEMENTS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @brief Pipes (bridges) and stations (articulation points) whose loss disconnects cities from every reservoir.
+ *
+ * Found with Tarjan's lowpoint DFS over the undirected view of pipesGraph, from a virtual root joined to every
+ * reservoir, so a DFS subtree cut off by a bridge or an articulation point has no reservoir. Pipes are taken once, a
+ * bidirectional pair being one undirected pipe, while separate pipes between the same stations stay parallel edges.
+ * Whatever the undirected view disconnects, the water can not reach either, so no max flow is needed.
+ */
+class CriticalElements {
+public:
+    /**
+     * @brief Analyses the current pipes of csvInfo::pipesGraph (those with capacity)
+     *
+     * Complexity: O(V + E)
+     *
+     * @return Critical elements
+     */
+    static CriticalElements fromPipesGraph();
+
+    /**
+     * @brief Get the cities cut off from every reservoir if a pipe stops carrying water in its direction
+     *
+     * Complexity: O(answer)
+     *
+     * @param e : Pipe (one direction of a bidirectional pipe)
+     * @return Codes of the cities (empty if the pipe is not critical)
+     */
+    vector<string> getCutOffCities(const Edge *e) const;
+
+    /**
+     * @brief Get the cities cut off from every reservoir if a station is removed
+     *
+     * Complexity: O(answer)
+     *
+     * @param v : Station
+     * @return Codes of the cities (empty if the station is not critical)
+     */
+    vector<string> getCutOffCities(const Vertex *v) const;
+
+    /**
+     * @brief Get number of critical pipes (each direction of a bidirectional pipe counted once)
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of pipes
+     */
+    int numCriticalPipes() const;
+
+    /**
+     * @brief Get number of critical stations
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of stations
+     */
+    int numCriticalStations() const;
+
+private:
+    vector<string> cityCodes;                                    // cities reached from a reservoir, in DFS preorder
+    vector<int> cityOrder;                                       // preorder number of each of them
+    vector<int> subtreeEnd;                                      // past the last preorder number of each subtree
+    unordered_map<const Edge *, int> pipeCuts;                   // subtree a pipe leads into
+    unordered_map<const Vertex *, vector<int>> stationCuts;      // subtrees only joined to the rest by a station
+
+    /**
+     * @brief Appends the cities of a DFS subtree to a list
+     *
+     * Complexity: O(log V + cities)
+     *
+     * @param root : Preorder number of the subtree root
+     * @param cities : List of city codes
+     */
+    void addCities(int root, vector<string> &cities) const;
+};
+
+#endif //DA2324_PRJ1_G13_4_CRITICALELEMENTS_H
@@ -0,0 +1,219 @@
+#include "DinicLinkCut.h"
+#include <limits>
+
+template <class Cap>
+static Cap infinite() {
+    return numeric_limits<Cap>::has_infinity ? numeric_limits<Cap>::infinity() : numeric_limits<Cap>::max();
+}
+
+template <class Cap>
+DinicLinkCut<Cap>::DinicLinkCut(FlowCore<Cap> &net): net(net) {}
+
+template <class Cap>
+int DinicLinkCut<Cap>::getPhases() const {
+    return phases;
+}
+
+template <class Cap>
+bool DinicLinkCut<Cap>::isSplayRoot(FlowId x) const {
+    FlowId y = up[x];
+    return y == NO_ID || (left[y] != x && right[y] != x);
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::addToSubtree(FlowId x, Cap delta) {
+    if (x == NO_ID) return;
+    value[x] += delta;
+    minValue[x] += delta;
+    pending[x] += delta;
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::pushDown(FlowId x) {
+    if (pending[x] == 0) return;
+    addToSubtree(left[x], pending[x]);
+    addToSubtree(right[x], pending[x]);
+    pending[x] = 0;
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::pullUp(FlowId x) {
+    minValue[x] = value[x];
+    minVertex[x] = x;
+    for (FlowId c : {left[x], right[x]}) {
+        if (c != NO_ID && minValue[c] < minValue[x]) {
+            minValue[x] = minValue[c];
+            minVertex[x] = minVertex[c];
+        }
+    }
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::rotate(FlowId x) {
+    FlowId y = up[x];
+    FlowId z = up[y];
+    if (!isSplayRoot(y)) {
+        if (left[z] == y) left[z] = x;
+        else right[z] = x;
+    }
+    up[x] = z;
+    if (left[y] == x) {
+        left[y] = right[x];
+        if (right[x] != NO_ID) up[right[x]] = y;
+        right[x] = y;
+    }
+    else {
+        right[y] = left[x];
+        if (left[x] != NO_ID) up[left[x]] = y;
+        left[x] = y;
+    }
+    up[y] = x;
+    pullUp(y);
+    pullUp(x);
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::splay(FlowId x) {
+    splayPath.clear();
+    splayPath.push_back(x);
+    for (FlowId y = x; !isSplayRoot(y); y = up[y]) splayPath.push_back(up[y]);
+    for (auto it = splayPath.rbegin(); it != splayPath.rend(); it++) pushDown(*it);
+
+    while (!isSplayRoot(x)) {
+        FlowId y = up[x];
+        if (!isSplayRoot(y)) {
+            FlowId z = up[y];
+            rotate((left[y] == x) == (left[z] == y) ? y : x);
+        }
+        rotate(x);
+    }
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::access(FlowId x) {
+    FlowId last = NO_ID;
+    for (FlowId y = x; y != NO_ID; y = up[y]) {
+        splay(y);
+        right[y] = last;
+        pullUp(y);
+        last = y;
+    }
+    splay(x);
+}
+
+template <class Cap>
+FlowId DinicLinkCut<Cap>::findRoot(FlowId x) {
+    access(x);
+    FlowId y = x;
+    pushDown(y);
+    while (left[y] != NO_ID) {
+        y = left[y];
+        pushDown(y);
+    }
+    splay(y);
+    return y;
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::detach(FlowId v) {
+    access(v);
+    FlowId a = parentArc[v];
+    net.setFlow(a, net.getCapacity(a) - value[v]);    // value = capacity - flow
+    parentArc[v] = NO_ID;
+    if (left[v] != NO_ID) up[left[v]] = NO_ID;
+    left[v] = NO_ID;
+    value[v] = infinite<Cap>();
+    pullUp(v);
+}
+
+template <class Cap>
+bool DinicLinkCut<Cap>::buildLevels() {
+    FlowId n = net.numVertices();
+    level.assign(n, NO_ID);
+    currentArc.resize(n);
+    for (FlowId v = 0; v < n; v++) currentArc[v] = net.firstArc(v);
+
+    vector<FlowId> queue = {net.getSource()};
+    level[net.getSource()] = 0;
+    for (size_t i = 0; i < queue.size(); i++) {
+        FlowId v = queue[i];
+        for (FlowId a = net.firstArc(v); a != NO_ID; a = net.nextArc(a)) {
+            FlowId w = net.getHead(a);
+            if (level[w] != NO_ID || net.getResidual(a) <= FlowCore<Cap>::epsilon()) continue;
+            level[w] = level[v] + 1;
+            if (w == net.getSink()) return true;    // deeper vertices can not be on a shortest path
+            queue.push_back(w);
+        }
+    }
+    return false;
+}
+
+template <class Cap>
+void DinicLinkCut<Cap>::blockingFlow() {
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    while (true) {
+        FlowId r = findRoot(source);    // r is now the root of the splay tree, the rest of the path its right subtree
+        if (r == sink) {
+            FlowId path = right[r];
+            if (minValue[path] <= FlowCore<Cap>::epsilon()) detach(minVertex[path]);
+            else {
+                addToSubtree(path, -minValue[path]);
+                pullUp(r);
+            }
+            continue;
+        }
+
+        // advance along the next admissible arc
+        FlowId a = currentArc[r];
+        while (a != NO_ID && (level[net.getHead(a)] != level[r] + 1 || net.getResidual(a) <= FlowCore<Cap>::epsilon())) {
+            a = net.nextArc(a);
+        }
+        currentArc[r] = a;
+        if (a != NO_ID) {
+            access(r);
+            value[r] = net.getResidual(a);
+            pullUp(r);
+            up[r] = net.getHead(a);
+            parentArc[r] = a;
+            continue;
+        }
+
+        // dead end: retreat, the children of r lose their arcs into it
+        if (r == source) break;
+        for (FlowId b = net.firstArc(r); b != NO_ID; b = net.nextArc(b)) {
+            FlowId u = net.getHead(b);
+            if (parentArc[u] == (b ^ 1)) detach(u);
+        }
+        level[r] = NO_ID;
+    }
+
+    for (FlowId v = 0; v < net.numVertices(); v++) {
+        if (parentArc[v] != NO_ID) detach(v);
+    }
+}
+
+template <class Cap>
+Cap DinicLinkCut<Cap>::solve() {
+    FlowId n = net.numVertices();
+    phases = 0;
+    parentArc.assign(n, NO_ID);
+    left.assign(n, NO_ID);
+    right.assign(n, NO_ID);
+    up.assign(n, NO_ID);
+    value.assign(n, infinite<Cap>());
+    minValue.assign(n, infinite<Cap>());
+    pending.assign(n, 0);
+    minVertex.resize(n);
+    for (FlowId v = 0; v < n; v++) minVertex[v] = v;
+
+    while (buildLevels()) {
+        phases++;
+        blockingFlow();
+    }
+    return net.getFlowValue();
+}
+
+template class DinicLinkCut<int32_t>;
+template class DinicLinkCut<int64_t>;
+template class DinicLinkCut<double>;
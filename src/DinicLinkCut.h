@@ -0,0 +1,166 @@
+#ifndef DA2324_PRJ1_G13_4_DINICLINKCUT_H
+#define DA2324_PRJ1_G13_4_DINICLINKCUT_H
+
+#include "FlowCore.h"
+
+/**
+ * @brief Dinic's algorithm with Sleator-Tarjan dynamic (link-cut) trees, for networks with very deep level graphs.
+ *
+ * Each phase builds the BFS levels from the source and then finds a blocking flow on the admissible arcs. The
+ * admissible arcs already explored form a forest rooted towards the sink, kept in a link-cut tree whose vertices hold
+ * the residual capacity of the arc to their parent. Sending flow along a whole source-root path, finding its
+ * bottleneck and cutting the saturated arcs each take O(log V) amortized instead of O(path length), so a blocking flow
+ * costs O(E log V) however long the chains are.
+ *
+ * Starts from the current flow of the network.
+ */
+template <class Cap>
+class DinicLinkCut {
+public:
+    /**
+     * @brief Prepares a solver
+     *
+     * Complexity: O(1)
+     *
+     * @param net : Network to solve
+     */
+    explicit DinicLinkCut(FlowCore<Cap> &net);
+
+    /**
+     * @brief Solves the max flow of the network, starting from its current flow
+     *
+     * Complexity: O(V E log V)
+     *
+     * @return Max flow
+     */
+    Cap solve();
+
+    /**
+     * @brief Get number of phases (blocking flows) of the last solve
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of phases
+     */
+    int getPhases() const;
+
+private:
+    FlowCore<Cap> &net;
+    int phases = 0;
+
+    vector<FlowId> level;
+    vector<FlowId> currentArc;
+    vector<FlowId> parentArc;    // arc linking each vertex to its tree parent, or NO_ID for tree roots
+
+    // link-cut tree: splay trees over the tree paths, ordered from the root down
+    vector<FlowId> left;
+    vector<FlowId> right;
+    vector<FlowId> up;           // splay parent, or path parent for the root of a splay tree
+    vector<Cap> value;           // residual capacity of parentArc (infinite for tree roots)
+    vector<Cap> minValue;        // smallest value in the splay subtree
+    vector<FlowId> minVertex;    // vertex holding it
+    vector<Cap> pending;         // amount still to be added to the values of the splay subtree
+    vector<FlowId> splayPath;    // scratch space of splay
+
+    /**
+     * @brief BFS levels from the source over arcs with residual capacity
+     *
+     * Complexity: O(V + E)
+     *
+     * @return True if the sink was reached
+     */
+    bool buildLevels();
+
+    /**
+     * @brief Finds a blocking flow on the admissible arcs
+     *
+     * Complexity: O(E log V) amortized
+     */
+    void blockingFlow();
+
+    /**
+     * @brief Unlinks a vertex from its tree parent and writes the flow of its arc back to the network
+     *
+     * Complexity: O(log V) amortized
+     *
+     * @param v : Vertex with a tree parent
+     */
+    void detach(FlowId v);
+
+    /**
+     * @brief Check if a vertex is the root of its splay tree
+     *
+     * Complexity: O(1)
+     *
+     * @param x : Vertex
+     * @return True or false
+     */
+    bool isSplayRoot(FlowId x) const;
+
+    /**
+     * @brief Adds an amount to every value of a splay subtree
+     *
+     * Complexity: O(1)
+     *
+     * @param x : Root of the subtree (or NO_ID)
+     * @param delta : Amount
+     */
+    void addToSubtree(FlowId x, Cap delta);
+
+    /**
+     * @brief Hands the pending amount of a vertex down to its children
+     *
+     * Complexity: O(1)
+     *
+     * @param x : Vertex
+     */
+    void pushDown(FlowId x);
+
+    /**
+     * @brief Recomputes the minimum of a splay subtree from its children
+     *
+     * Complexity: O(1)
+     *
+     * @param x : Vertex
+     */
+    void pullUp(FlowId x);
+
+    /**
+     * @brief Rotates a vertex above its splay parent
+     *
+     * Complexity: O(1)
+     *
+     * @param x : Vertex
+     */
+    void rotate(FlowId x);
+
+    /**
+     * @brief Moves a vertex to the root of its splay tree
+     *
+     * Complexity: O(log V) amortized
+     *
+     * @param x : Vertex
+     */
+    void splay(FlowId x);
+
+    /**
+     * @brief Makes the path from the tree root to a vertex one splay tree, rooted at that vertex
+     *
+     * Complexity: O(log V) amortized
+     *
+     * @param x : Vertex
+     */
+    void access(FlowId x);
+
+    /**
+     * @brief Get the root of the tree of a vertex
+     *
+     * Complexity: O(log V) amortized
+     *
+     * @param x : Vertex
+     * @return Tree root
+     */
+    FlowId findRoot(FlowId x);
+};
+
+#endif //DA2324_PRJ1_G13_4_DINICLINKCUT_H
@@ -0,0 +1,119 @@
+#include "DominatorTree.h"
+
+DominatorTree::DominatorTree(const FlowNetwork &net) {
+    FlowId n = net.numVertices();
+    FlowId source = net.getSource();
+    auto usable = [&](FlowId a) { return (a & 1) == 0 && net.getCapacity(a) > FlowCore<double>::epsilon(); };
+
+    // predecessors over usable arcs (CSR)
+    vector<FlowId> predStart(n + 1, 0);
+    for (FlowId a = 0; a < net.numArcs(); a++) {
+        if (usable(a)) predStart[net.getHead(a) + 1]++;
+    }
+    for (FlowId v = 0; v < n; v++) predStart[v + 1] += predStart[v];
+    vector<FlowId> preds(predStart[n]);
+    vector<FlowId> position(predStart.begin(), predStart.end() - 1);
+    for (FlowId a = 0; a < net.numArcs(); a++) {
+        if (usable(a)) preds[position[net.getHead(a)]++] = net.getTail(a);
+    }
+
+    // depth-first numbering from the source
+    vector<FlowId> number(n, NO_ID), order, parent(n, NO_ID);
+    vector<pair<FlowId, FlowId>> stack = {{source, net.firstArc(source)}};
+    number[source] = 0;
+    order.push_back(source);
+    while (!stack.empty()) {
+        FlowId v = stack.back().first;
+        FlowId &a = stack.back().second;
+        while (a != NO_ID && (!usable(a) || number[net.getHead(a)] != NO_ID)) a = net.nextArc(a);
+        if (a == NO_ID) {
+            stack.pop_back();
+            continue;
+        }
+        FlowId w = net.getHead(a);
+        number[w] = (FlowId) order.size();
+        order.push_back(w);
+        parent[w] = v;
+        stack.emplace_back(w, net.firstArc(w));
+    }
+
+    // semidominators, in reverse preorder, over a forest with path compression
+    vector<FlowId> semi(n, NO_ID), label(n), ancestor(n, NO_ID), path;
+    vector<vector<FlowId>> bucket(n);
+    idom.assign(n, NO_ID);
+    for (FlowId v : order) {
+        semi[v] = number[v];
+        label[v] = v;
+    }
+    auto eval = [&](FlowId v) {
+        if (ancestor[v] == NO_ID) return v;
+        path.clear();
+        for (FlowId x = v; ancestor[ancestor[x]] != NO_ID; x = ancestor[x]) path.push_back(x);
+        for (auto it = path.rbegin(); it != path.rend(); it++) {
+            FlowId a = ancestor[*it];
+            if (semi[label[a]] < semi[label[*it]]) label[*it] = label[a];
+            ancestor[*it] = ancestor[a];
+        }
+        return label[v];
+    };
+    for (FlowId i = (FlowId) order.size() - 1; i > 0; i--) {
+        FlowId w = order[i];
+        for (FlowId p = predStart[w]; p < predStart[w + 1]; p++) {
+            if (number[preds[p]] == NO_ID) continue;
+            FlowId u = eval(preds[p]);
+            if (semi[u] < semi[w]) semi[w] = semi[u];
+        }
+        bucket[order[semi[w]]].push_back(w);
+        ancestor[w] = parent[w];
+        for (FlowId v : bucket[parent[w]]) {
+            FlowId u = eval(v);
+            idom[v] = semi[u] < semi[v] ? u : parent[w];
+        }
+        bucket[parent[w]].clear();
+    }
+    for (FlowId i = 1; i < order.size(); i++) {
+        FlowId w = order[i];
+        if (idom[w] != order[semi[w]]) idom[w] = idom[idom[w]];
+    }
+
+    // preorder of the dominator tree
+    vector<FlowId> childStart(n + 1, 0);
+    for (FlowId v : order) {
+        if (idom[v] != NO_ID) childStart[idom[v] + 1]++;
+    }
+    for (FlowId v = 0; v < n; v++) childStart[v + 1] += childStart[v];
+    vector<FlowId> children(childStart[n]);
+    position.assign(childStart.begin(), childStart.end() - 1);
+    for (FlowId v : order) {
+        if (idom[v] != NO_ID) children[position[idom[v]]++] = v;
+    }
+    enter.assign(n, NO_ID);
+    leave.assign(n, NO_ID);
+    FlowId counter = 0;
+    vector<pair<FlowId, FlowId>> visit = {{source, childStart[source]}};
+    enter[source] = counter++;
+    while (!visit.empty()) {
+        FlowId v = visit.back().first;
+        FlowId &c = visit.back().second;
+        if (c == childStart[v + 1]) {
+            leave[v] = counter++;
+            visit.pop_back();
+            continue;
+        }
+        FlowId w = children[c++];
+        enter[w] = counter++;
+        visit.emplace_back(w, childStart[w]);
+    }
+}
+
+bool DominatorTree::isReachable(FlowId v) const {
+    return enter[v] != NO_ID;
+}
+
+FlowId DominatorTree::getImmediateDominator(FlowId v) const {
+    return idom[v];
+}
+
+bool DominatorTree::dominates(FlowId d, FlowId v) const {
+    return isReachable(d) && isReachable(v) && enter[d] <= enter[v] && leave[v] <= leave[d];
+}
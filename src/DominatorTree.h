@@ -0,0 +1,61 @@
+#ifndef DA2324_PRJ1_G13_4_DOMINATORTREE_H
+#define DA2324_PRJ1_G13_4_DOMINATORTREE_H
+
+#include "FlowNetwork.h"
+
+/**
+ * @brief Dominators of the vertices of a network, from its source.
+ *
+ * Vertex d dominates v if every path from the source to v (over arcs with capacity) goes through d, so removing d cuts
+ * v off from every reservoir. Built with the Lengauer-Tarjan algorithm (simple version, path compression only) and
+ * numbered by a preorder of the tree, so that each dominance query is O(1).
+ */
+class DominatorTree {
+public:
+    /**
+     * @brief Builds the dominator tree of a network
+     *
+     * Complexity: O(E log V)
+     *
+     * @param net : Network
+     */
+    explicit DominatorTree(const FlowNetwork &net);
+
+    /**
+     * @brief Check if a vertex can be reached from the source
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @return True or false
+     */
+    bool isReachable(FlowId v) const;
+
+    /**
+     * @brief Get the immediate dominator of a vertex
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @return Immediate dominator, or NO_ID for the source and the vertices it does not reach
+     */
+    FlowId getImmediateDominator(FlowId v) const;
+
+    /**
+     * @brief Check if every path from the source to a vertex goes through another (a vertex dominates itself)
+     *
+     * Complexity: O(1)
+     *
+     * @param d : Possible dominator
+     * @param v : Vertex
+     * @return True or false (false if either is not reachable)
+     */
+    bool dominates(FlowId d, FlowId v) const;
+
+private:
+    vector<FlowId> idom;
+    vector<FlowId> enter;    // preorder interval of each subtree of the dominator tree
+    vector<FlowId> leave;
+};
+
+#endif //DA2324_PRJ1_G13_4_DOMINATORTREE_H
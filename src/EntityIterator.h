@@ -0,0 +1,46 @@
+#ifndef DA2324_PRJ1_G13_4_ENTITYITERATOR_H
+#define DA2324_PRJ1_G13_4_ENTITYITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+
+/**
+ * @brief Iterator over the rows of a columnar table (CityTable, ReservoirTable, StationTable).
+ *
+ * Dereferencing gives a small view of the row (Entity), built from the table and the row number, so a range-for over a
+ * table copies no strings.
+ */
+template <class Table, class Entity>
+class EntityIterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Entity value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Entity *pointer;
+    typedef Entity reference;
+
+    EntityIterator(const Table *table, size_t row) : table(table), row(row) {}
+
+    Entity operator*() const {
+        return Entity(table, row);
+    }
+
+    EntityIterator &operator++() {
+        row++;
+        return *this;
+    }
+
+    bool operator==(const EntityIterator &other) const {
+        return row == other.row;
+    }
+
+    bool operator!=(const EntityIterator &other) const {
+        return row != other.row;
+    }
+
+private:
+    const Table *table;
+    size_t row;
+};
+
+#endif //DA2324_PRJ1_G13_4_ENTITYITERATOR_H
@@ -0,0 +1,471 @@
+#include "FlowCore.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <type_traits>
+
+template <class Cap>
+FlowCore<Cap>::FlowCore() = default;
+
+template <class Cap>
+FlowId FlowCore<Cap>::addVertex() {
+    first.push_back(NO_ID);
+    return (FlowId) first.size() - 1;
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::addArc(FlowId u, FlowId v, Cap cap) {
+    FlowId a = (FlowId) head.size();
+    head.push_back(v);
+    capacity.push_back(cap);
+    flow.push_back(0);
+    next.push_back(first[u]);
+    first[u] = a;
+
+    head.push_back(u);
+    capacity.push_back(0);
+    flow.push_back(0);
+    next.push_back(first[v]);
+    first[v] = a + 1;
+    return a;
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::numVertices() const {
+    return (FlowId) first.size();
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::numArcs() const {
+    return (FlowId) head.size();
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::getSource() const {
+    return source;
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::getSink() const {
+    return sink;
+}
+
+template <class Cap>
+void FlowCore<Cap>::setTerminals(FlowId s, FlowId t) {
+    source = s;
+    sink = t;
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::firstArc(FlowId v) const {
+    return first[v];
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::nextArc(FlowId a) const {
+    return next[a];
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::getHead(FlowId a) const {
+    return head[a];
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::getTail(FlowId a) const {
+    return head[a ^ 1];
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::getCapacity(FlowId a) const {
+    return capacity[a];
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::getFlow(FlowId a) const {
+    return flow[a];
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::getResidual(FlowId a) const {
+    return capacity[a] - flow[a];
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::epsilon() {
+    return std::is_integral<Cap>::value ? 0 : (Cap) 1e-9;
+}
+
+template <class Cap>
+void FlowCore<Cap>::setFlow(FlowId a, Cap f) {
+    flow[a] = f;
+    flow[a ^ 1] = -f;
+}
+
+template <class Cap>
+void FlowCore<Cap>::setCapacity(FlowId a, Cap cap) {
+    capacity[a] = cap;
+    if (flow[a] <= cap + epsilon()) return;
+
+    Cap surplus = flow[a] - cap;
+    flow[a] = cap;
+    flow[a ^ 1] = -cap;
+    vector<Cap> excess(first.size(), 0);
+    excess[head[a ^ 1]] += surplus;
+    excess[head[a]] -= surplus;
+    restoreConservation(excess);
+}
+
+template <class Cap>
+template <class Target>
+FlowId FlowCore<Cap>::findPath(FlowId from, FlowId blocked, Target isTarget, PathSearch &search) const {
+    startSearch(from, search);
+    return continueSearch(blocked, isTarget, search);
+}
+
+template <class Cap>
+void FlowCore<Cap>::startSearch(FlowId from, PathSearch &search) const {
+    search.visited.reset(first.size());
+    if (search.parent.size() < first.size()) search.parent.resize(first.size());
+    search.queue.clear();
+    search.visited.visit(from);
+    search.queue.push_back(from);
+}
+
+template <class Cap>
+template <class Target>
+FlowId FlowCore<Cap>::continueSearch(FlowId blocked, Target isTarget, PathSearch &search) const {
+    for (size_t i = 0; i < search.queue.size(); i++) {
+        FlowId v = search.queue[i];
+        for (FlowId a = first[v]; a != NO_ID; a = next[a]) {
+            FlowId w = head[a];
+            if (search.visited.isVisited(w) || w == blocked || capacity[a] - flow[a] <= epsilon()) continue;
+            search.visited.visit(w);
+            search.parent[w] = a;
+            if (isTarget(w)) return w;
+            search.queue.push_back(w);
+        }
+    }
+    return NO_ID;
+}
+
+
+template <class Cap>
+bool FlowCore<Cap>::findShortestPath(PathSearch &search) const {
+    FlowId n = first.size();
+    if (search.degree.size() != n) {
+        search.degree.assign(n, 0);
+        for (FlowId a = 0; a < head.size(); a++) search.degree[head[a]]++;    // every arc has a twin leaving head[a]
+    }
+    search.visited.reset(n);
+    search.reached.reset(n);
+    if (search.parent.size() < n) search.parent.resize(n);
+    if (search.child.size() < n) search.child.resize(n);
+    if (search.frontierBits.size() < (n + 63) / 64) search.frontierBits.resize((n + 63) / 64, 0);
+    search.queue.assign(1, source);
+    search.backQueue.assign(1, sink);
+    search.visited.visit(source);
+    search.reached.visit(sink);
+
+    // arcs a top-down step would scan, and the most a bottom-up step would (listed once a side goes bottom-up)
+    size_t frontierArcs[2] = {search.degree[sink], search.degree[source]};
+    size_t unseenArcs[2] = {head.size() - frontierArcs[0], head.size() - frontierArcs[1]};
+    bool listed[2] = {false, false};
+    FlowId meet = NO_ID;
+    while (meet == NO_ID && !search.queue.empty() && !search.backQueue.empty()) {
+        bool forward = search.queue.size() <= search.backQueue.size();
+        if (frontierArcs[forward] > unseenArcs[forward] + (listed[forward] ? 0 : n)) {
+            vector<FlowId> &unseen = forward ? search.unseen : search.backUnseen;
+            const VisitMarks &own = forward ? search.visited : search.reached;
+            if (!listed[forward]) {
+                unseen.clear();
+                for (FlowId v = 0; v < n; v++) {
+                    if (!own.isVisited(v)) unseen.push_back(v);
+                }
+                listed[forward] = true;
+            }
+            meet = growBottomUp(forward, search, frontierArcs[forward]);
+        }
+        else meet = growTopDown(forward, search, frontierArcs[forward]);
+        unseenArcs[forward] -= frontierArcs[forward];
+    }
+    if (meet == NO_ID) return false;
+
+    for (FlowId v = meet; v != sink; v = head[search.child[v]]) {
+        search.parent[head[search.child[v]]] = search.child[v];
+    }
+    return true;
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::growTopDown(bool forward, PathSearch &search, size_t &arcs) const {
+    vector<FlowId> &frontier = forward ? search.queue : search.backQueue;
+    VisitMarks &own = forward ? search.visited : search.reached;
+    const VisitMarks &other = forward ? search.reached : search.visited;
+    vector<FlowId> &via = forward ? search.parent : search.child;
+    search.following.clear();
+    arcs = 0;
+    for (FlowId v : frontier) {
+        for (FlowId a = first[v]; a != NO_ID; a = next[a]) {
+            FlowId w = head[a];
+            FlowId arc = forward ? a : a ^ 1;    // the sink side walks the arcs into v
+            if (own.isVisited(w) || capacity[arc] - flow[arc] <= epsilon()) continue;
+            own.visit(w);
+            via[w] = arc;
+            if (other.isVisited(w)) return w;
+            search.following.push_back(w);
+            arcs += search.degree[w];
+        }
+    }
+    frontier.swap(search.following);
+    return NO_ID;
+}
+
+template <class Cap>
+FlowId FlowCore<Cap>::growBottomUp(bool forward, PathSearch &search, size_t &arcs) const {
+    vector<FlowId> &frontier = forward ? search.queue : search.backQueue;
+    vector<FlowId> &unseen = forward ? search.unseen : search.backUnseen;
+    VisitMarks &own = forward ? search.visited : search.reached;
+    const VisitMarks &other = forward ? search.reached : search.visited;
+    vector<FlowId> &via = forward ? search.parent : search.child;
+    vector<uint64_t> &bits = search.frontierBits;
+    for (FlowId v : frontier) bits[v >> 6] |= (uint64_t) 1 << (v & 63);
+
+    search.following.clear();
+    arcs = 0;
+    FlowId meet = NO_ID;
+    size_t kept = 0;
+    for (FlowId w : unseen) {
+        if (own.isVisited(w)) continue;    // seen by a top-down step since the list was last compacted
+        for (FlowId a = first[w]; a != NO_ID; a = next[a]) {
+            FlowId v = head[a];
+            FlowId arc = forward ? a ^ 1 : a;    // v -> w for the source side, w -> v for the sink side
+            if (!(bits[v >> 6] >> (v & 63) & 1) || capacity[arc] - flow[arc] <= epsilon()) continue;
+            own.visit(w);
+            via[w] = arc;
+            if (other.isVisited(w)) meet = w;
+            search.following.push_back(w);
+            arcs += search.degree[w];
+            break;
+        }
+        if (!own.isVisited(w)) unseen[kept++] = w;
+        if (meet != NO_ID) break;
+    }
+    unseen.resize(kept);
+
+    for (FlowId v : frontier) bits[v >> 6] = 0;
+    frontier.swap(search.following);
+    return meet;
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::findMinResidual(FlowId from, FlowId to, const PathSearch &search) const {
+    Cap f = std::numeric_limits<Cap>::max();
+    for (FlowId v = to; v != from; v = head[search.parent[v] ^ 1]) {
+        FlowId a = search.parent[v];
+        f = std::min(f, capacity[a] - flow[a]);
+    }
+    return f;
+}
+
+template <class Cap>
+void FlowCore<Cap>::pushAlongPath(FlowId from, FlowId to, const PathSearch &search, Cap f) {
+    for (FlowId v = to; v != from; v = head[search.parent[v] ^ 1]) {
+        flow[search.parent[v]] += f;
+        flow[search.parent[v] ^ 1] -= f;
+    }
+}
+
+template <class Cap>
+void FlowCore<Cap>::restoreConservation(vector<Cap> &excess) {
+    PathSearch search;
+
+    // surplus goes to a vertex short of water, or back to the source (or to the sink, if it came through an arc
+    // leaving the sink)
+    for (FlowId v = 0; v < first.size(); v++) {
+        while (excess[v] > epsilon() && v != source && v != sink) {
+            FlowId target = findPath(v, sink, [&](FlowId w) { return w == source || excess[w] < -epsilon(); }, search);
+            if (target == NO_ID) target = findPath(v, NO_ID, [&](FlowId w) { return w == sink; }, search);
+            if (target == NO_ID) break;
+            Cap f = std::min(excess[v], findMinResidual(v, target, search));
+            if (target != source && target != sink) f = std::min(f, -excess[target]);
+            pushAlongPath(v, target, search, f);
+            excess[v] -= f;
+            excess[target] += f;
+        }
+    }
+
+    // what is still missing stops being delivered to the sink (or, if it went out through an arc entering the source,
+    // is taken from the source)
+    for (FlowId v = 0; v < first.size(); v++) {
+        while (excess[v] < -epsilon() && v != source && v != sink) {
+            FlowId from = sink;
+            if (findPath(sink, source, [&](FlowId w) { return w == v; }, search) == NO_ID) {
+                from = source;
+                if (findPath(source, sink, [&](FlowId w) { return w == v; }, search) == NO_ID) break;
+            }
+            Cap f = std::min(-excess[v], findMinResidual(from, v, search));
+            pushAlongPath(from, v, search, f);
+            excess[v] += f;
+        }
+    }
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::maxFlow() {
+    PathSearch search;
+    while (findShortestPath(search)) {
+        pushAlongPath(source, sink, search, findMinResidual(source, sink, search));
+    }
+    return getFlowValue();
+}
+
+template <class Cap>
+void FlowCore<Cap>::canonicalizeFlows() {
+    if (source == NO_ID || sink == NO_ID) return;
+    PathSearch search;
+    int64_t cost;
+
+    // the cheapest max flow, by successive cheapest paths from no flow
+    vector<bool> fixed(numArcs() / 2, false);
+    std::fill(flow.begin(), flow.end(), (Cap) 0);
+    while (findCheapestPath(source, sink, fixed, search, cost)) {
+        pushAlongPath(source, sink, search, findMinResidual(source, sink, search));
+    }
+
+    // the arcs entering the sink, in order, each raised along residual cycles that cost nothing (so the flow stays the
+    // cheapest) and avoid the ones already fixed
+    for (FlowId arc = 0; arc < numArcs(); arc += 2) {
+        if (head[arc] != sink) continue;
+        fixed[arc >> 1] = true;
+        FlowId from = head[arc], to = head[arc ^ 1];
+        while (capacity[arc] - flow[arc] > epsilon() && findCheapestPath(from, to, fixed, search, cost) && cost == 0) {
+            Cap f = std::min(capacity[arc] - flow[arc], findMinResidual(from, to, search));
+            pushAlongPath(from, to, search, f);
+            flow[arc] += f;
+            flow[arc ^ 1] -= f;
+        }
+    }
+}
+
+template <class Cap>
+int64_t FlowCore<Cap>::arcCost(FlowId a) const {
+    FlowId u = head[a ^ 1], v = head[a];
+    if (u == source || u == sink || v == source || v == sink) return 0;
+    return (a & 1) ? -1 : 1;
+}
+
+template <class Cap>
+bool FlowCore<Cap>::findCheapestPath(FlowId from, FlowId to, const vector<bool> &fixed, PathSearch &search,
+                                     int64_t &cost) const {
+    FlowId n = (FlowId) first.size();
+    if (search.parent.size() < n) search.parent.resize(n);
+    vector<int64_t> dist(n, std::numeric_limits<int64_t>::max());
+    vector<bool> queued(n, false);
+    dist[from] = 0;
+    queued[from] = true;
+    search.queue.assign(1, from);
+    for (size_t q = 0; q < search.queue.size(); q++) {
+        FlowId v = search.queue[q];
+        queued[v] = false;
+        for (FlowId a = first[v]; a != NO_ID; a = next[a]) {
+            FlowId w = head[a];
+            if (fixed[a >> 1] || capacity[a] - flow[a] <= epsilon() || dist[v] + arcCost(a) >= dist[w]) continue;
+            dist[w] = dist[v] + arcCost(a);
+            search.parent[w] = a;
+            if (!queued[w]) {
+                queued[w] = true;
+                search.queue.push_back(w);
+            }
+        }
+    }
+    cost = dist[to];
+    return to != from && dist[to] != std::numeric_limits<int64_t>::max();
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::maxFlowThrough(const FlowId *begin, const FlowId *end) {
+    PathSearch search;
+    auto isSink = [&](FlowId w) { return w == sink; };
+    while (true) {
+        // first level by hand, so that the source's other arcs are not even read
+        startSearch(source, search);
+        search.queue.clear();
+        FlowId found = NO_ID;
+        for (const FlowId *a = begin; a != end && found == NO_ID; a++) {
+            FlowId w = head[*a];
+            if (search.visited.isVisited(w) || capacity[*a] - flow[*a] <= epsilon()) continue;
+            search.visited.visit(w);
+            search.parent[w] = *a;
+            if (w == sink) found = w;
+            search.queue.push_back(w);
+        }
+        if (found == NO_ID) found = continueSearch(NO_ID, isSink, search);
+        if (found == NO_ID) break;
+        pushAlongPath(source, sink, search, findMinResidual(source, sink, search));
+    }
+
+    Cap total = 0;
+    for (const FlowId *a = begin; a != end; a++) {
+        total += flow[*a];
+    }
+    return total;
+}
+
+template <class Cap>
+Cap FlowCore<Cap>::getFlowValue() const {
+    Cap total = 0;
+    for (FlowId a = first[source]; a != NO_ID; a = next[a]) {
+        total += flow[a];
+    }
+    return total;
+}
+
+template <class Cap>
+vector<bool> FlowCore<Cap>::getSourceSide() const {
+    vector<bool> side(first.size(), false);
+    vector<FlowId> queue = {source};
+    side[source] = true;
+    for (size_t i = 0; i < queue.size(); i++) {
+        for (FlowId a = first[queue[i]]; a != NO_ID; a = next[a]) {
+            if (side[head[a]] || capacity[a] - flow[a] <= epsilon()) continue;
+            side[head[a]] = true;
+            queue.push_back(head[a]);
+        }
+    }
+    return side;
+}
+
+template <class Cap>
+vector<bool> FlowCore<Cap>::getSinkSide() const {
+    vector<bool> side(first.size(), false);
+    vector<FlowId> queue = {sink};
+    side[sink] = true;
+    for (size_t i = 0; i < queue.size(); i++) {
+        // w reaches v through the twin of each arc v -> w
+        for (FlowId a = first[queue[i]]; a != NO_ID; a = next[a]) {
+            if (side[head[a]] || capacity[a ^ 1] - flow[a ^ 1] <= epsilon()) continue;
+            side[head[a]] = true;
+            queue.push_back(head[a]);
+        }
+    }
+    return side;
+}
+
+template <class Cap>
+CapacityKind FlowCore<Cap>::getCapacityKind() const {
+    double total = 0;
+    for (FlowId a = 0; a < head.size(); a += 2) {
+        double c = (double) capacity[a];
+        if (c != std::floor(c) || (double) flow[a] != std::floor((double) flow[a])) return DOUBLE_CAPACITY;
+        total += std::fabs(c);
+    }
+    // residual capacities reach up to twice a capacity, and flow values up to the sum of them
+    if (total < (double) (std::numeric_limits<int32_t>::max() / 2)) return INT32_CAPACITY;
+    if (total < (double) (std::numeric_limits<int64_t>::max() / 2)) return INT64_CAPACITY;
+    return DOUBLE_CAPACITY;
+}
+
+template class FlowCore<int32_t>;
+template class FlowCore<int64_t>;
+template class FlowCore<double>;
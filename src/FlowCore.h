@@ -0,0 +1,503 @@
+#ifndef DA2324_PRJ1_G13_4_FLOWCORE_H
+#define DA2324_PRJ1_G13_4_FLOWCORE_H
+
+#include <cstdint>
+#include <vector>
+#include "VisitMarks.h"
+using namespace std;
+
+/**
+ * @brief Vertex or arc id of a flow network
+ */
+typedef uint32_t FlowId;
+
+/**
+ * @brief Missing vertex or arc
+ */
+const FlowId NO_ID = UINT32_MAX;
+
+/**
+ * @brief Narrowest capacity type that represents every capacity of a network exactly
+ */
+enum CapacityKind { INT32_CAPACITY, INT64_CAPACITY, DOUBLE_CAPACITY };
+
+/**
+ * @brief Scratch space of the breadth-first searches of one solver, reused from search to search
+ */
+class PathSearch {
+public:
+    /**
+     * @brief Vertices reached by the current search
+     */
+    VisitMarks visited;
+
+    /**
+     * @brief Arc used to reach each vertex (only meaningful for visited vertices)
+     */
+    vector<FlowId> parent;
+
+    /**
+     * @brief BFS queue (the source side frontier in a search from both ends)
+     */
+    vector<FlowId> queue;
+
+    /**
+     * @brief Vertices reached from the sink side in a search from both ends
+     */
+    VisitMarks reached;
+
+    /**
+     * @brief Arc leaving each vertex reached from the sink side, towards the sink
+     */
+    vector<FlowId> child;
+
+    /**
+     * @brief Sink side frontier in a search from both ends
+     */
+    vector<FlowId> backQueue;
+
+    /**
+     * @brief Next level of the frontier being grown
+     */
+    vector<FlowId> following;
+
+    /**
+     * @brief One bit per vertex, set for the frontier of a bottom-up step (all zero between steps)
+     */
+    vector<uint64_t> frontierBits;
+
+    /**
+     * @brief Vertices not seen yet by the source / sink side, once that side has gone bottom-up
+     */
+    vector<FlowId> unseen, backUnseen;
+
+    /**
+     * @brief Number of arcs leaving each vertex (filled by the first search from both ends)
+     */
+    vector<FlowId> degree;
+};
+
+/**
+ * @brief Residual network and Edmonds Karp solver, parameterized on the capacity type (int32_t, int64_t or double).
+ *
+ * Arcs are stored in flat arrays (forward star) with 32-bit ids and every arc a has its residual twin a ^ 1, whose
+ * flow is always the symmetric of a's. With integer capacities all arithmetic is exact.
+ */
+template <class Cap>
+class FlowCore {
+public:
+    /**
+     * @brief Default constructor
+     *
+     * Complexity: O(1)
+     */
+    FlowCore();
+
+    /**
+     * @brief Copies a core with another capacity type
+     *
+     * Complexity: O(V + E)
+     *
+     * @param other : Core to copy
+     */
+    template <class Other>
+    explicit FlowCore(const FlowCore<Other> &other);
+
+    /**
+     * @brief Adds a vertex
+     *
+     * Complexity: O(1)
+     *
+     * @return Id of the new vertex
+     */
+    FlowId addVertex();
+
+    /**
+     * @brief Adds an arc u -> v and its residual twin v -> u (capacity 0)
+     *
+     * Complexity: O(1)
+     *
+     * @param u : Tail vertex
+     * @param v : Head vertex
+     * @param cap : Capacity
+     * @return Id of the new arc (its twin is id ^ 1)
+     */
+    FlowId addArc(FlowId u, FlowId v, Cap cap);
+
+    /**
+     * @brief Get number of vertices
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of vertices
+     */
+    FlowId numVertices() const;
+
+    /**
+     * @brief Get number of arcs, residual twins included
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of arcs
+     */
+    FlowId numArcs() const;
+
+    /**
+     * @brief Get source
+     *
+     * Complexity: O(1)
+     *
+     * @return Vertex id
+     */
+    FlowId getSource() const;
+
+    /**
+     * @brief Get sink
+     *
+     * Complexity: O(1)
+     *
+     * @return Vertex id
+     */
+    FlowId getSink() const;
+
+    /**
+     * @brief Set source and sink
+     *
+     * Complexity: O(1)
+     *
+     * @param s : Source vertex
+     * @param t : Sink vertex
+     */
+    void setTerminals(FlowId s, FlowId t);
+
+    /**
+     * @brief Get first arc leaving a vertex
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex id
+     * @return Arc id, or NO_ID
+     */
+    FlowId firstArc(FlowId v) const;
+
+    /**
+     * @brief Get next arc leaving the same vertex
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Arc id, or NO_ID
+     */
+    FlowId nextArc(FlowId a) const;
+
+    /**
+     * @brief Get head of an arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Vertex id
+     */
+    FlowId getHead(FlowId a) const;
+
+    /**
+     * @brief Get tail of an arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Vertex id
+     */
+    FlowId getTail(FlowId a) const;
+
+    /**
+     * @brief Get capacity of an arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Capacity
+     */
+    Cap getCapacity(FlowId a) const;
+
+    /**
+     * @brief Get flow of an arc (the twin carries the symmetric value)
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Flow
+     */
+    Cap getFlow(FlowId a) const;
+
+    /**
+     * @brief Get residual capacity of an arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Capacity minus flow
+     */
+    Cap getResidual(FlowId a) const;
+
+    /**
+     * @brief Sets the flow of an arc (and the symmetric flow of its twin). The caller keeps the flow conservation.
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @param f : Flow, at most the capacity
+     */
+    void setFlow(FlowId a, Cap f);
+
+    /**
+     * @brief Changes the capacity of an arc, keeping the current flow valid. If the arc carries more than the new
+     * capacity, the surplus is rerouted or sent back to the source (the max flow must then be re-run).
+     *
+     * Complexity: O(V + E) if the flow has to be repaired, O(1) otherwise
+     *
+     * @param a : Arc id
+     * @param cap : New capacity
+     */
+    void setCapacity(FlowId a, Cap cap);
+
+    /**
+     * @brief Edmonds Karp from the source to the sink, starting from the current flow
+     *
+     * Complexity: O(V E^2)
+     *
+     * @return Total flow leaving the source
+     */
+    Cap maxFlow();
+
+    /**
+     * @brief Replaces the flow by a max flow that sends the least water through the arcs between two vertices that are
+     * not terminals (the pipes), so no water goes round in circles or both ways between two vertices. Among those,
+     * the flows entering the sink are the lexicographically greatest, in the order the arcs were added (i.e. the
+     * cities in order). The result only depends on the network, not on the engine or the flow it started from. The
+     * cheapest max flow is built by successive cheapest paths, then each arc entering the sink in turn is raised along
+     * residual cycles through it that cost nothing and avoid the ones already fixed.
+     *
+     * Complexity: O((k + C + r) V E), k = number of paths, C = arcs entering the sink, r = number of reroutes
+     */
+    void canonicalizeFlows();
+
+    /**
+     * @brief Edmonds Karp restricted to the paths that leave the source through some of its arcs. If the part of the
+     * network reached through them shares no vertex but the terminals with the rest, only that part is read and
+     * written, so disjoint parts can be solved by different threads at the same time.
+     *
+     * Complexity: O(V' E'^2), V' and E' = vertices and arcs of the part
+     *
+     * @param begin : First arc leaving the source
+     * @param end : Past the last arc
+     * @return Total flow through those arcs
+     */
+    Cap maxFlowThrough(const FlowId *begin, const FlowId *end);
+
+    /**
+     * @brief Get total flow leaving the source
+     *
+     * Complexity: O(deg(s))
+     *
+     * @return Flow value
+     */
+    Cap getFlowValue() const;
+
+    /**
+     * @brief Get the source side of the minimum cut: vertices reachable from the source in the residual network
+     *
+     * Complexity: O(V + E)
+     *
+     * @return Whether each vertex is on the source side
+     */
+    vector<bool> getSourceSide() const;
+
+    /**
+     * @brief Get the sink side of the minimum cut closest to the sink: vertices that reach the sink in the residual network
+     *
+     * Complexity: O(V + E)
+     *
+     * @return Whether each vertex is on the sink side
+     */
+    vector<bool> getSinkSide() const;
+
+    /**
+     * @brief Get the narrowest capacity type that holds every capacity and flow of this core exactly
+     *
+     * Complexity: O(E)
+     *
+     * @return Capacity kind
+     */
+    CapacityKind getCapacityKind() const;
+
+    /**
+     * @brief Smallest residual capacity considered usable (0 for integers)
+     *
+     * Complexity: O(1)
+     *
+     * @return Tolerance
+     */
+    static Cap epsilon();
+
+protected:
+    template <class> friend class FlowCore;
+
+    // arcs
+    vector<FlowId> head;
+    vector<FlowId> next;
+    vector<Cap> capacity;
+    vector<Cap> flow;
+
+    // vertices
+    vector<FlowId> first;
+
+    FlowId source = NO_ID;
+    FlowId sink = NO_ID;
+
+    /**
+     * @brief BFS over arcs with residual capacity
+     *
+     * Complexity: O(V + E)
+     *
+     * @param from : Start vertex
+     * @param blocked : Vertex that can not be crossed (NO_ID for none)
+     * @param isTarget : Which vertices end the search
+     * @param search : Search scratch space, holding the path found (output)
+     * @return Target found, or NO_ID
+     */
+    template <class Target>
+    FlowId findPath(FlowId from, FlowId blocked, Target isTarget, PathSearch &search) const;
+
+    /**
+     * @brief Clears a search, leaving only the start vertex visited and queued
+     *
+     * Complexity: O(1) amortized
+     *
+     * @param from : Start vertex
+     * @param search : Search scratch space
+     */
+    void startSearch(FlowId from, PathSearch &search) const;
+
+    /**
+     * @brief Goes on with a BFS over arcs with residual capacity from the vertices in its queue
+     *
+     * Complexity: O(V + E)
+     *
+     * @param blocked : Vertex that can not be crossed (NO_ID for none)
+     * @param isTarget : Which vertices end the search
+     * @param search : Search scratch space, holding the path found (output)
+     * @return Target found, or NO_ID
+     */
+    template <class Target>
+    FlowId continueSearch(FlowId blocked, Target isTarget, PathSearch &search) const;
+
+    /**
+     * @brief Shortest path from the source to the sink over arcs with residual capacity, searched from both ends.
+     *
+     * Each step grows the side with the smaller frontier by one level, top-down (the frontier scans its arcs) or, when
+     * the frontier has more arcs than the vertices its side has not seen yet, bottom-up (each of those vertices looks
+     * for an arc from a frontier vertex, marked in a bitmap). Since whole levels are grown, the first vertex seen by both
+     * sides lies on a shortest path. The sink half is then written into parent, as if findPath had found it.
+     *
+     * Complexity: O(V + E)
+     *
+     * @param search : Search scratch space, holding the path found (output)
+     * @return True if the sink was reached
+     */
+    bool findShortestPath(PathSearch &search) const;
+
+    /**
+     * @brief Grows one side of findShortestPath by a level, scanning the arcs of its frontier
+     *
+     * Complexity: O(arcs of the frontier)
+     *
+     * @param forward : True for the source side, false for the sink side
+     * @param search : Search scratch space
+     * @param arcs : Number of arcs of the new frontier (output)
+     * @return Vertex seen by both sides, or NO_ID
+     */
+    FlowId growTopDown(bool forward, PathSearch &search, size_t &arcs) const;
+
+    /**
+     * @brief Grows one side of findShortestPath by a level, scanning the arcs of the vertices its side has not seen
+     *
+     * Complexity: O(vertices not seen and their arcs)
+     *
+     * @param forward : True for the source side, false for the sink side
+     * @param search : Search scratch space
+     * @param arcs : Number of arcs of the new frontier (output)
+     * @return Vertex seen by both sides, or NO_ID
+     */
+    FlowId growBottomUp(bool forward, PathSearch &search, size_t &arcs) const;
+
+    /**
+     * @brief Cost of sending a unit of flow along an arc: 1 between two vertices that are not terminals (-1 back along
+     * it), nothing if the arc touches the source or the sink
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc
+     * @return Cost
+     */
+    int64_t arcCost(FlowId a) const;
+
+    /**
+     * @brief Bellman-Ford over arcs with residual capacity, with the costs of arcCost. The residual network must have
+     * no cycle of negative cost.
+     *
+     * Complexity: O(V E)
+     *
+     * @param from : Start vertex
+     * @param to : End vertex
+     * @param fixed : Whether each pair of arcs (indexed by arc / 2) can not be used
+     * @param search : Search scratch space, holding the path found (output)
+     * @param cost : Cost of the path found (output)
+     * @return True if the end vertex was reached
+     */
+    bool findCheapestPath(FlowId from, FlowId to, const vector<bool> &fixed, PathSearch &search, int64_t &cost) const;
+
+    /**
+     * @brief Sends f units along the path found by findPath
+     *
+     * Complexity: O(V)
+     *
+     * @param from : Start vertex
+     * @param to : End vertex
+     * @param search : Search that found the path
+     * @param f : Amount
+     */
+    void pushAlongPath(FlowId from, FlowId to, const PathSearch &search, Cap f);
+
+    /**
+     * @brief Get bottleneck of the path found by findPath
+     *
+     * Complexity: O(V)
+     *
+     * @param from : Start vertex
+     * @param to : End vertex
+     * @param search : Search that found the path
+     * @return Minimum residual capacity along the path
+     */
+    Cap findMinResidual(FlowId from, FlowId to, const PathSearch &search) const;
+
+    /**
+     * @brief Removes surplus (excess > 0) and shortfall (excess < 0) left by lowering capacities, by
+     * rerouting through the residual network or returning water to the source / taking it from the sink. Water that
+     * can only have come from the sink (through an arc leaving it) goes back to the sink, and water that can only have
+     * gone to the source is taken from the source.
+     *
+     * Complexity: O(k (V + E)), k = number of unbalanced vertices
+     *
+     * @param excess : Inflow minus outflow of each vertex
+     */
+    void restoreConservation(vector<Cap> &excess);
+};
+
+template <class Cap>
+template <class Other>
+FlowCore<Cap>::FlowCore(const FlowCore<Other> &other):
+        head(other.head), next(other.next), capacity(other.capacity.begin(), other.capacity.end()),
+        flow(other.flow.begin(), other.flow.end()), first(other.first), source(other.source), sink(other.sink) {}
+
+#endif //DA2324_PRJ1_G13_4_FLOWCORE_H
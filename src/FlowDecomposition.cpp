@@ -0,0 +1,143 @@
+#include "FlowDecomposition.h"
+#include "csvInfo.h"
+
+FlowDecomposition::FlowDecomposition() = default;
+
+FlowDecomposition::FlowDecomposition(const FlowNetwork &net) {
+    const double EPS = 1e-9;
+    reservoirs = (int) csvInfo::reservoirsVector.size();
+    cities = (int) csvInfo::citiesVector.size();
+    matrix.assign((size_t) reservoirs * cities, 0);
+    reservoirTotals.assign(reservoirs, 0);
+    cityTotals.assign(cities, 0);
+    pathStart.push_back(0);
+
+    vector<int> reservoirOf(net.numArcs(), -1);
+    vector<int> cityOf(net.numArcs(), -1);
+    for (int r = 0; r < reservoirs; r++) reservoirOf[net.getReservoirArc(r)] = r;
+    for (int c = 0; c < cities; c++) cityOf[net.getCityArc(c)] = c;
+
+    // flow still to decompose on each arc (twins, with their negative flow, are never followed)
+    vector<double> rest(net.numArcs(), 0);
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        if (net.getFlow(a) > EPS) rest[a] = net.getFlow(a);
+    }
+    vector<FlowId> current(net.numVertices());
+    for (FlowId v = 0; v < net.numVertices(); v++) current[v] = net.firstArc(v);
+    vector<int> onStack(net.numVertices(), -1);    // depth of each vertex in the current walk
+
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    vector<FlowId> stack;
+    vector<FlowId> vertices = {source};
+    onStack[source] = 0;
+    while (true) {
+        FlowId v = vertices.back();
+        if (v == sink) {
+            double f = rest[stack[0]];
+            for (FlowId a : stack) f = min(f, rest[a]);
+            for (FlowId a : stack) rest[a] -= f;
+
+            int r = reservoirOf[stack.front()];
+            int c = cityOf[stack.back()];
+            pathArcs.insert(pathArcs.end(), stack.begin() + 1, stack.end() - 1);
+            pathStart.push_back((uint32_t) pathArcs.size());
+            pathFlow.push_back(f);
+            pathReservoir.push_back(r);
+            pathCity.push_back(c);
+            matrix[(size_t) r * cities + c] += f;
+            reservoirTotals[r] += f;
+            cityTotals[c] += f;
+
+            // back to the source
+            for (FlowId w : vertices) onStack[w] = -1;
+            stack.clear();
+            vertices.assign(1, source);
+            onStack[source] = 0;
+            continue;
+        }
+
+        FlowId &a = current[v];
+        while (a != NO_ID && rest[a] <= EPS) a = net.nextArc(a);
+        if (a == NO_ID) {
+            if (v == source) break;
+            // no water leaves v (rounding): drop what is left on the way in
+            rest[stack.back()] = 0;
+            onStack[v] = -1;
+            vertices.pop_back();
+            stack.pop_back();
+            continue;
+        }
+
+        FlowId w = net.getHead(a);
+        if (onStack[w] != -1) {
+            // cycle w -> ... -> v -> w: cancel it and continue from w
+            int depth = onStack[w];
+            double f = rest[a];
+            for (int i = depth; i < (int) stack.size(); i++) f = min(f, rest[stack[i]]);
+            rest[a] -= f;
+            for (int i = depth; i < (int) stack.size(); i++) rest[stack[i]] -= f;
+            for (int i = depth + 1; i < (int) vertices.size(); i++) onStack[vertices[i]] = -1;
+            vertices.resize(depth + 1);
+            stack.resize(depth);
+            continue;
+        }
+        onStack[w] = (int) vertices.size();
+        vertices.push_back(w);
+        stack.push_back(a);
+    }
+
+    // index of the paths crossing each arc
+    arcStart.assign(net.numArcs() + 1, 0);
+    for (FlowId a : pathArcs) arcStart[a + 1]++;
+    for (FlowId a = 0; a < net.numArcs(); a++) arcStart[a + 1] += arcStart[a];
+    arcPaths.resize(pathArcs.size());
+    vector<uint32_t> fill(arcStart.begin(), arcStart.end() - 1);
+    for (int p = 0; p < numPaths(); p++) {
+        for (uint32_t i = pathStart[p]; i < pathStart[p + 1]; i++) arcPaths[fill[pathArcs[i]]++] = p;
+    }
+}
+
+int FlowDecomposition::numPaths() const {
+    return (int) pathFlow.size();
+}
+
+double FlowDecomposition::getPathFlow(int p) const {
+    return pathFlow[p];
+}
+
+int FlowDecomposition::getPathReservoir(int p) const {
+    return pathReservoir[p];
+}
+
+int FlowDecomposition::getPathCity(int p) const {
+    return pathCity[p];
+}
+
+const FlowId *FlowDecomposition::pathBegin(int p) const {
+    return pathArcs.data() + pathStart[p];
+}
+
+const FlowId *FlowDecomposition::pathEnd(int p) const {
+    return pathArcs.data() + pathStart[p + 1];
+}
+
+const int *FlowDecomposition::arcPathsBegin(FlowId a) const {
+    return arcPaths.data() + arcStart[a];
+}
+
+const int *FlowDecomposition::arcPathsEnd(FlowId a) const {
+    return arcPaths.data() + arcStart[a + 1];
+}
+
+double FlowDecomposition::getWater(int reservoir, int city) const {
+    return matrix[(size_t) reservoir * cities + city];
+}
+
+double FlowDecomposition::getReservoirWater(int reservoir) const {
+    return reservoirTotals[reservoir];
+}
+
+double FlowDecomposition::getCityWater(int city) const {
+    return cityTotals[city];
+}
@@ -0,0 +1,163 @@
+#ifndef DA2324_PRJ1_G13_4_FLOWDECOMPOSITION_H
+#define DA2324_PRJ1_G13_4_FLOWDECOMPOSITION_H
+
+#include "FlowNetwork.h"
+
+/**
+ * @brief Decomposition of a max flow into reservoir -> city paths.
+ *
+ * Paths are stored back to back in one array of arc ids (CSR), with the offset, flow, reservoir and city of each path.
+ * The water each city gets from each reservoir is kept in a dense reservoirs x cities matrix, and the paths crossing
+ * each arc in a second CSR index, so that all queries are O(1) (or O(answer) for lists).
+ */
+class FlowDecomposition {
+public:
+    /**
+     * @brief Default constructor (no paths)
+     *
+     * Complexity: O(1)
+     */
+    FlowDecomposition();
+
+    /**
+     * @brief Decomposes the flow of a solved network. Flow cycles (e.g. both directions of a bidirectional pipe) carry no
+     * water from a reservoir to a city and are cancelled.
+     *
+     * Complexity: O(E * (V + paths))
+     *
+     * @param net : Solved network
+     */
+    explicit FlowDecomposition(const FlowNetwork &net);
+
+    /**
+     * @brief Get number of paths
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of paths
+     */
+    int numPaths() const;
+
+    /**
+     * @brief Get water carried by a path
+     *
+     * Complexity: O(1)
+     *
+     * @param p : Path index
+     * @return Flow
+     */
+    double getPathFlow(int p) const;
+
+    /**
+     * @brief Get reservoir a path starts at
+     *
+     * Complexity: O(1)
+     *
+     * @param p : Path index
+     * @return Position in reservoirsVector
+     */
+    int getPathReservoir(int p) const;
+
+    /**
+     * @brief Get city a path ends at
+     *
+     * Complexity: O(1)
+     *
+     * @param p : Path index
+     * @return Position in citiesVector
+     */
+    int getPathCity(int p) const;
+
+    /**
+     * @brief Get first pipe arc of a path (arcs from the reservoir to the city, without the super source and super sink arcs)
+     *
+     * Complexity: O(1)
+     *
+     * @param p : Path index
+     * @return Pointer to the first arc id
+     */
+    const FlowId *pathBegin(int p) const;
+
+    /**
+     * @brief Get end of the pipe arcs of a path
+     *
+     * Complexity: O(1)
+     *
+     * @param p : Path index
+     * @return Pointer past the last arc id
+     */
+    const FlowId *pathEnd(int p) const;
+
+    /**
+     * @brief Get first path crossing an arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Pointer to the first path index
+     */
+    const int *arcPathsBegin(FlowId a) const;
+
+    /**
+     * @brief Get end of the paths crossing an arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Pointer past the last path index
+     */
+    const int *arcPathsEnd(FlowId a) const;
+
+    /**
+     * @brief Get water a city gets from a reservoir
+     *
+     * Complexity: O(1)
+     *
+     * @param reservoir : Position in reservoirsVector
+     * @param city : Position in citiesVector
+     * @return Water
+     */
+    double getWater(int reservoir, int city) const;
+
+    /**
+     * @brief Get water a reservoir delivers to every city together
+     *
+     * Complexity: O(1)
+     *
+     * @param reservoir : Position in reservoirsVector
+     * @return Water
+     */
+    double getReservoirWater(int reservoir) const;
+
+    /**
+     * @brief Get water a city gets from every reservoir together
+     *
+     * Complexity: O(1)
+     *
+     * @param city : Position in citiesVector
+     * @return Water
+     */
+    double getCityWater(int city) const;
+
+private:
+    int reservoirs = 0;
+    int cities = 0;
+
+    // paths (CSR)
+    vector<uint32_t> pathStart;
+    vector<FlowId> pathArcs;
+    vector<double> pathFlow;
+    vector<int> pathReservoir;
+    vector<int> pathCity;
+
+    // paths crossing each arc (CSR)
+    vector<uint32_t> arcStart;
+    vector<int> arcPaths;
+
+    // reservoirs x cities
+    vector<double> matrix;
+    vector<double> reservoirTotals;
+    vector<double> cityTotals;
+};
+
+#endif //DA2324_PRJ1_G13_4_FLOWDECOMPOSITION_H
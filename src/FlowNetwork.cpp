@@ -0,0 +1,204 @@
+#include "FlowNetwork.h"
+#include "csvInfo.h"
+#include <algorithm>
+#include <cmath>
+
+template <class Cap>
+BasicFlowNetwork<Cap>::BasicFlowNetwork() = default;
+
+template <class Cap>
+BasicFlowNetwork<Cap> BasicFlowNetwork<Cap>::fromPipesGraph() {
+    BasicFlowNetwork<Cap> net;
+    auto info = make_shared<NetworkLabels>();
+    vector<Vertex *> vertexSet = csvInfo::pipesGraph.getVertexSet();
+    for (Vertex* v : vertexSet) {
+        info->ids[v->getInfo()] = net.addVertex();
+        info->codes.push_back(v->getInfo());
+    }
+    for (FlowId u = 0; u < vertexSet.size(); u++) {
+        for (Edge* e : vertexSet[u]->getAdj()) {
+            net.addArc(u, info->ids[e->getDest()->getInfo()], (Cap) e->getWeight());
+            info->edges.push_back(e);
+            info->edges.push_back(nullptr);
+            info->pipes.push_back(e->getReverse() != nullptr ? TWO_WAY_PIPE : ONE_WAY_PIPE);
+            info->pipes.push_back(NOT_PIPE);
+        }
+    }
+
+    FlowId source = net.addVertex();
+    info->codes.emplace_back("super_source");
+    FlowId sink = net.addVertex();
+    info->codes.emplace_back("super_sink");
+    net.setTerminals(source, sink);
+
+    info->reservoirArcs.assign(csvInfo::reservoirsVector.size(), NO_ID);
+    info->cityArcs.assign(csvInfo::citiesVector.size(), NO_ID);
+    for (FlowId u = 0; u < vertexSet.size(); u++) {
+        Vertex* v = vertexSet[u];
+        if (v->getType() == 1) {
+            info->reservoirArcs[v->getPos()] = net.addArc(source, u, (Cap) csvInfo::reservoirsVector[v->getPos()].getMaxDelivery());
+        }
+        else if (v->getType() == 0) {
+            info->cityArcs[v->getPos()] = net.addArc(u, sink, (Cap) csvInfo::citiesVector[v->getPos()].getDemand());
+        }
+        else continue;
+        info->edges.push_back(nullptr);
+        info->edges.push_back(nullptr);
+        info->pipes.push_back(NOT_PIPE);
+        info->pipes.push_back(NOT_PIPE);
+    }
+    net.labels = info;
+    return net;
+}
+
+template <class Cap>
+FlowId BasicFlowNetwork<Cap>::findVertex(const string &code) const {
+    auto it = labels->ids.find(code);
+    if (it == labels->ids.end()) return NO_ID;
+    return it->second;
+}
+
+template <class Cap>
+const string &BasicFlowNetwork<Cap>::getCode(FlowId v) const {
+    return labels->codes[v];
+}
+
+template <class Cap>
+FlowId BasicFlowNetwork<Cap>::getReservoirArc(int pos) const {
+    return labels->reservoirArcs[pos];
+}
+
+template <class Cap>
+FlowId BasicFlowNetwork<Cap>::getCityArc(int pos) const {
+    return labels->cityArcs[pos];
+}
+
+template <class Cap>
+Edge *BasicFlowNetwork<Cap>::getEdge(FlowId a) const {
+    return labels->edges[a];
+}
+
+template <class Cap>
+bool BasicFlowNetwork<Cap>::isPipe(FlowId a) const {
+    return labels->pipes[a] != NOT_PIPE;
+}
+
+template <class Cap>
+bool BasicFlowNetwork<Cap>::isBidirectional(FlowId a) const {
+    return labels->pipes[a] == TWO_WAY_PIPE;
+}
+
+template <class Cap>
+vector<FlowId> BasicFlowNetwork<Cap>::findPipeArcs(FlowId a, FlowId b) const {
+    vector<FlowId> arcs;
+    bool bidirectional = false;
+    for (FlowId e = this->firstArc(a); e != NO_ID; e = this->nextArc(e)) {
+        if (isPipe(e) && this->getHead(e) == b) {
+            arcs.push_back(e);
+            if (isBidirectional(e)) bidirectional = true;
+        }
+    }
+    if (bidirectional) {
+        for (FlowId e = this->firstArc(b); e != NO_ID; e = this->nextArc(e)) {
+            if (isBidirectional(e) && this->getHead(e) == a) arcs.push_back(e);
+        }
+    }
+    return arcs;
+}
+
+template <class Cap>
+NetworkLabels &BasicFlowNetwork<Cap>::ownLabels() {
+    if (labels.use_count() > 1) labels = make_shared<NetworkLabels>(*labels);
+    return const_cast<NetworkLabels &>(*labels);    // created non-const by make_shared and not shared
+}
+
+template <class Cap>
+FlowId BasicFlowNetwork<Cap>::addStation(const string &code) {
+    if (findVertex(code) != NO_ID || code == "super_source" || code == "super_sink") return NO_ID;
+    NetworkLabels &info = ownLabels();
+    FlowId v = this->addVertex();
+    info.ids[code] = v;
+    info.codes.push_back(code);
+    return v;
+}
+
+template <class Cap>
+FlowId BasicFlowNetwork<Cap>::addPipe(FlowId u, FlowId v, Cap cap, bool bidirectional) {
+    NetworkLabels &info = ownLabels();
+    PipeKind kind = bidirectional ? TWO_WAY_PIPE : ONE_WAY_PIPE;
+    FlowId a = this->addArc(u, v, cap);
+    info.edges.push_back(nullptr);
+    info.edges.push_back(nullptr);
+    info.pipes.push_back(kind);
+    info.pipes.push_back(NOT_PIPE);
+    if (bidirectional) {
+        this->addArc(v, u, cap);
+        info.edges.push_back(nullptr);
+        info.edges.push_back(nullptr);
+        info.pipes.push_back(kind);
+        info.pipes.push_back(NOT_PIPE);
+    }
+    return a;
+}
+
+template <class Cap>
+vector<double> BasicFlowNetwork<Cap>::getCityFlows() const {
+    vector<double> res(labels->cityArcs.size(), 0);
+    for (size_t i = 0; i < labels->cityArcs.size(); i++) {
+        if (labels->cityArcs[i] != NO_ID) res[i] = (double) this->flow[labels->cityArcs[i]];
+    }
+    return res;
+}
+
+template <class Cap>
+void BasicFlowNetwork<Cap>::balanceFlows() {
+    FlowId n = this->numVertices();
+    FlowId m = this->numArcs();
+    vector<FlowId> opposite(m, NO_ID);
+    Cap largest = 0;
+    for (FlowId a = 0; a < m; a += 2) {
+        this->flow[a] = this->flow[a ^ 1] = 0;
+        largest = max(largest, this->capacity[a]);
+        if (!isBidirectional(a)) continue;
+        for (FlowId b : findPipeArcs(this->getTail(a), this->getHead(a))) {
+            if (this->getTail(b) == this->getHead(a)) opposite[a] = b;
+        }
+    }
+    vector<Cap> capacities(this->capacity);
+
+    // same steps as AuxFunctions::compute_delta
+    double delta = 0;
+    for (int i = 0; pow(2, i) < (double) largest; i++) delta = pow(2, i);
+
+    vector<FlowId> parent(n);
+    vector<FlowId> queue;
+    for (; delta >= 1; delta /= 2) {
+        while (true) {
+            fill(parent.begin(), parent.end(), NO_ID);
+            queue.assign(1, this->source);
+            for (size_t i = 0; i < queue.size() && parent[this->sink] == NO_ID; i++) {
+                for (FlowId a = this->first[queue[i]]; a != NO_ID; a = this->next[a]) {
+                    FlowId w = this->head[a];
+                    if (w == this->source || parent[w] != NO_ID || (double) this->getResidual(a) < delta) continue;
+                    parent[w] = a;
+                    queue.push_back(w);
+                }
+            }
+            if (parent[this->sink] == NO_ID) break;
+
+            Cap f = this->getResidual(parent[this->sink]);
+            for (FlowId v = this->sink; v != this->source; v = this->getTail(parent[v])) f = min(f, this->getResidual(parent[v]));
+            for (FlowId v = this->sink; v != this->source; v = this->getTail(parent[v])) {
+                FlowId a = parent[v];
+                this->setFlow(a, this->flow[a] + f);
+                // once a bidirectional pipe carries water one way, the other way is closed
+                if ((a & 1) == 0 && opposite[a] != NO_ID && this->flow[opposite[a]] == 0) this->capacity[opposite[a]] = 0;
+            }
+        }
+    }
+    this->capacity = capacities;
+}
+
+template class BasicFlowNetwork<int32_t>;
+template class BasicFlowNetwork<int64_t>;
+template class BasicFlowNetwork<double>;
@@ -0,0 +1,234 @@
+#ifndef DA2324_PRJ1_G13_4_FLOWNETWORK_H
+#define DA2324_PRJ1_G13_4_FLOWNETWORK_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "FlowCore.h"
+#include "Graph.h"
+
+/**
+ * @brief Whether an arc of a FlowNetwork is a pipe, and of which kind
+ */
+enum PipeKind : uint8_t { NOT_PIPE, ONE_WAY_PIPE, TWO_WAY_PIPE };
+
+/**
+ * @brief What the vertices and arcs of a FlowNetwork stand for. Shared by all copies of a network.
+ */
+class NetworkLabels {
+public:
+    /**
+     * @brief Code of each vertex ("super_source"/"super_sink" for the terminals)
+     */
+    vector<string> codes;
+
+    /**
+     * @brief Vertex id of each code
+     */
+    unordered_map<string, FlowId> ids;
+
+    /**
+     * @brief Pipe of pipesGraph each arc was built from (nullptr for super source/sink arcs, residual twins and added pipes)
+     */
+    vector<Edge *> edges;
+
+    /**
+     * @brief Kind of pipe of each arc (NOT_PIPE for super source/sink arcs and residual twins)
+     */
+    vector<PipeKind> pipes;
+
+    /**
+     * @brief Arc from the super source to each reservoir, indexed like reservoirsVector
+     */
+    vector<FlowId> reservoirArcs;
+
+    /**
+     * @brief Arc from each city to the super sink, indexed like citiesVector
+     */
+    vector<FlowId> cityArcs;
+};
+
+/**
+ * @brief Flow network of the water supply system, used by the batch analyses.
+ *
+ * A super source feeds every reservoir (capacity = max delivery) and every city drains to a super sink
+ * (capacity = demand). Unlike pipesGraph, a network owns its flow, so copies of a solved network can be
+ * modified and re-solved independently (and concurrently) starting from that flow.
+ */
+template <class Cap>
+class BasicFlowNetwork : public FlowCore<Cap> {
+public:
+    /**
+     * @brief Default constructor
+     *
+     * Complexity: O(1)
+     */
+    BasicFlowNetwork();
+
+    /**
+     * @brief Copies a network with another capacity type
+     *
+     * Complexity: O(V + E)
+     *
+     * @param other : Network to copy
+     */
+    template <class Other>
+    explicit BasicFlowNetwork(const BasicFlowNetwork<Other> &other);
+
+    /**
+     * @brief Builds the network of csvInfo::pipesGraph
+     *
+     * Complexity: O(V + E)
+     *
+     * @return Network with no flow
+     */
+    static BasicFlowNetwork fromPipesGraph();
+
+    /**
+     * @brief Get the id of the vertex with a given code
+     *
+     * Complexity: O(1)
+     *
+     * @param code : Reservoir, station or city code
+     * @return Vertex id, or NO_ID if there is no such vertex
+     */
+    FlowId findVertex(const string &code) const;
+
+    /**
+     * @brief Get the code of a vertex
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex id
+     * @return Code, or "super_source"/"super_sink"
+     */
+    const string &getCode(FlowId v) const;
+
+    /**
+     * @brief Get the arc from the super source to a reservoir
+     *
+     * Complexity: O(1)
+     *
+     * @param pos : Position of the reservoir in reservoirsVector
+     * @return Arc id
+     */
+    FlowId getReservoirArc(int pos) const;
+
+    /**
+     * @brief Get the arc from a city to the super sink
+     *
+     * Complexity: O(1)
+     *
+     * @param pos : Position of the city in citiesVector
+     * @return Arc id
+     */
+    FlowId getCityArc(int pos) const;
+
+    /**
+     * @brief Get the pipe of pipesGraph that an arc was built from
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Edge, or nullptr for super source/sink arcs, residual twins and pipes added by edits
+     */
+    Edge *getEdge(FlowId a) const;
+
+    /**
+     * @brief Check if an arc is a pipe (loaded or added by an edit)
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return True or false
+     */
+    bool isPipe(FlowId a) const;
+
+    /**
+     * @brief Check if an arc is one direction of a bidirectional pipe
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return True or false
+     */
+    bool isBidirectional(FlowId a) const;
+
+    /**
+     * @brief Get the pipe arcs between two vertices (both directions for bidirectional pipes)
+     *
+     * Complexity: O(deg(a) + deg(b))
+     *
+     * @param a : Origin of the pipe
+     * @param b : Destination of the pipe
+     * @return Arc ids
+     */
+    vector<FlowId> findPipeArcs(FlowId a, FlowId b) const;
+
+    /**
+     * @brief Adds a pumping station, not connected to anything
+     *
+     * Complexity: O(1) amortized (O(V + E) if the labels are shared with another copy)
+     *
+     * @param code : Station code
+     * @return Vertex id, or NO_ID if the code is already used
+     */
+    FlowId addStation(const string &code);
+
+    /**
+     * @brief Adds a pipe with no flow. The max flow must then be re-run, which only augments from the current flow.
+     *
+     * Complexity: O(1) amortized (O(V + E) if the labels are shared with another copy)
+     *
+     * @param u : Origin
+     * @param v : Destination
+     * @param cap : Capacity
+     * @param bidirectional : Whether water can also go from v to u (with the same capacity)
+     * @return Arc u -> v
+     */
+    FlowId addPipe(FlowId u, FlowId v, Cap cap, bool bidirectional);
+
+    /**
+     * @brief Get the water reaching each city
+     *
+     * Complexity: O(C)
+     *
+     * @return Flow of each city, indexed like citiesVector
+     */
+    vector<double> getCityFlows() const;
+
+    /**
+     * @brief Replaces the flow with a balanced one, found like AuxFunctions::balanceNetwork does on pipesGraph: capacity
+     * scaling from no flow, augmenting along paths of residual at least delta for delta = 2^k, ..., 1, where a
+     * bidirectional pipe only carries water one way. Unlike pipesGraph, the network keeps the edits made to it.
+     * Capacities are left unchanged.
+     *
+     * Complexity: O(E^2 log U), U = largest capacity
+     */
+    void balanceFlows();
+
+protected:
+    template <class> friend class BasicFlowNetwork;
+
+    shared_ptr<const NetworkLabels> labels;
+
+    /**
+     * @brief Get the labels for modification, copying them first if another network shares them
+     *
+     * Complexity: O(1), O(V + E) if they are shared
+     *
+     * @return Labels owned by this network only
+     */
+    NetworkLabels &ownLabels();
+};
+
+/**
+ * @brief Network with real capacities, able to represent any scenario
+ */
+typedef BasicFlowNetwork<double> FlowNetwork;
+
+template <class Cap>
+template <class Other>
+BasicFlowNetwork<Cap>::BasicFlowNetwork(const BasicFlowNetwork<Other> &other): FlowCore<Cap>(other), labels(other.labels) {}
+
+#endif //DA2324_PRJ1_G13_4_FLOWNETWORK_H
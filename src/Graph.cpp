@@ -16,14 +16,6 @@ std::vector<Edge*> Vertex::getAdj() const {
     return this->adj;
 }
 
-bool Vertex::isVisited() const {
-    return this->visited;
-}
-
-Edge *Vertex::getPath() const {
-    return this->path;
-}
-
 std::vector<Edge *> Vertex::getIncoming() const {
     return this->incoming;
 }
@@ -32,12 +24,12 @@ int Vertex::getPos() {
     return this->vectorPos;
 }
 
-void Vertex::setVisited(bool visited) {
-    this->visited = visited;
+int Vertex::getIndex() const {
+    return this->index;
 }
 
-void Vertex::setPath(Edge *path) {
-    this->path = path;
+void Vertex::setIndex(int i) {
+    this->index = i;
 }
 
 Edge * Vertex::addEdge(Vertex *d, double w) {
@@ -47,6 +39,11 @@ Edge * Vertex::addEdge(Vertex *d, double w) {
     return newEdge;
 }
 
+void Vertex::reserveEdges(size_t out, size_t in) {
+    adj.reserve(adj.size() + out);
+    incoming.reserve(incoming.size() + in);
+}
+
 bool Vertex::removeEdge(string in) {
     bool removedEdge = false;
     auto it = adj.begin();
@@ -135,18 +132,22 @@ std::vector<Vertex*> Graph::getVertexSet() const {
     return vertexSet;
 }
 
+int Graph::getNumVertex() const {
+    return (int) vertexSet.size();
+}
+
 
 Vertex* Graph::findVertex(const string &in) const {
-    for (auto v : vertexSet)
-        if (v->getInfo() == in)
-            return v;
-    return nullptr;
+    auto it = vertexIndex.find(in);
+    return it == vertexIndex.end() ? nullptr : it->second;
 }
 
 bool Graph::addVertex(const string &in, int t, int pos) {
     if (findVertex(in) != nullptr)
         return false;
     vertexSet.push_back(new Vertex(in, t, pos));
+    vertexSet.back()->setIndex((int) vertexSet.size() - 1);
+    vertexIndex[in] = vertexSet.back();
     return true;
 }
 
@@ -163,7 +164,11 @@ bool Graph::removeVertex(const string &in) {
             for (auto u : vertexSet) {
                 u->removeEdge(v->getInfo());
             }
-            vertexSet.erase(it);
+            vertexIndex.erase(in);
+            it = vertexSet.erase(it);
+            for (; it != vertexSet.end(); it++) {
+                (*it)->setIndex((*it)->getIndex() - 1);
+            }
             delete v;
             return true;
         }
@@ -192,6 +197,78 @@ bool Graph::addBidirectionalEdge(const string &sourc, const string &dest, double
     return true;
 }
 
+bool Graph::addEdges(const vector<EdgeSpec> &edges) {
+    vector<pair<Vertex *, Vertex *>> ends(edges.size(), {nullptr, nullptr});
+    vector<size_t> out(vertexSet.size(), 0), in(vertexSet.size(), 0);
+    bool all = true;
+    for (size_t i = 0; i < edges.size(); i++) {
+        Vertex *v1 = findVertex(edges[i].orig);
+        Vertex *v2 = findVertex(edges[i].dest);
+        if (v1 == nullptr || v2 == nullptr) {
+            all = false;
+            continue;
+        }
+        ends[i] = {v1, v2};
+        out[v1->getIndex()]++;
+        in[v2->getIndex()]++;
+        if (edges[i].bidirectional) {
+            out[v2->getIndex()]++;
+            in[v1->getIndex()]++;
+        }
+    }
+    for (Vertex *v : vertexSet) v->reserveEdges(out[v->getIndex()], in[v->getIndex()]);
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        Vertex *v1 = ends[i].first, *v2 = ends[i].second;
+        if (v1 == nullptr) continue;
+        auto e1 = v1->addEdge(v2, edges[i].weight);
+        if (!edges[i].bidirectional) continue;
+        auto e2 = v2->addEdge(v1, edges[i].weight);
+        e1->setReverse(e2);
+        e2->setReverse(e1);
+    }
+    return all;
+}
+
+/********************** SearchState  ****************************/
+
+void SearchState::begin(const Graph &g) {
+    visited.reset(g.getNumVertex());
+    if ((int) path.size() < g.getNumVertex()) path.resize(g.getNumVertex(), nullptr);
+    reached.reset(g.getNumVertex());
+    if ((int) toward.size() < g.getNumVertex()) toward.resize(g.getNumVertex(), nullptr);
+}
+
+bool SearchState::isVisited(const Vertex *v) const {
+    return visited.isVisited(v->getIndex());
+}
+
+void SearchState::setVisited(const Vertex *v) {
+    visited.visit(v->getIndex());
+}
+
+Edge *SearchState::getPath(const Vertex *v) const {
+    return path[v->getIndex()];
+}
+
+void SearchState::setPath(const Vertex *v, Edge *e) {
+    if ((int) path.size() <= v->getIndex()) path.resize(v->getIndex() + 1, nullptr);
+    path[v->getIndex()] = e;
+}
+
+bool SearchState::isReached(const Vertex *v) const {
+    return reached.isVisited(v->getIndex());
+}
+
+void SearchState::setReached(const Vertex *v, Edge *e) {
+    reached.visit(v->getIndex());
+    toward[v->getIndex()] = e;
+}
+
+Edge *SearchState::getToward(const Vertex *v) const {
+    return toward[v->getIndex()];
+}
+
 inline void deleteMatrix(int **m, int n) {
     if (m != nullptr) {
         for (int i = 0; i < n; i++)
@@ -6,9 +6,11 @@
 #include <queue>
 #include <limits>
 #include <algorithm>
+#include <unordered_map>
 #include "Reservoir.h"
 #include "Station.h"
 #include "src/City.h"
+#include "VisitMarks.h"
 
 using namespace std;
 
@@ -61,24 +63,6 @@ public:
      */
     std::vector<Edge *> getAdj() const;
 
-    /**
-     * @brief Check if is visited
-     *
-     * Complexity: O(1)
-     *
-     * @return True or false
-     */
-    bool isVisited() const;
-
-    /**
-     * @brief Get path
-     *
-     * Complexity: O(1)
-     *
-     * @return Path
-     */
-    Edge *getPath() const;
-
     /**
      * @brief Get vector with incoming edges
      *
@@ -98,22 +82,22 @@ public:
     int getPos();
 
     /**
-     * @brief Set visited
+     * @brief Get the position of the vertex in the vertexSet of its graph
      *
      * Complexity: O(1)
      *
-     * @param visited : True or false
+     * @return Index
      */
-    void setVisited(bool visited);
+    int getIndex() const;
 
     /**
-     * @brief Set path
+     * @brief Set the position of the vertex in the vertexSet of its graph
      *
      * Complexity: O(1)
      *
-     * @param path : Edge
+     * @param i : Index
      */
-    void setPath(Edge *path);
+    void setIndex(int i);
 
     /**
      * Auxiliary function to add an outgoing edge to a vertex (this), with a given destination vertex (d) and edge weight (w)
@@ -126,6 +110,16 @@ public:
      */
     Edge * addEdge(Vertex *dest, double w);
 
+    /**
+     * @brief Reserves room for more edges, so that adding them does not reallocate
+     *
+     * Complexity: O(degree)
+     *
+     * @param out : Number of outgoing edges to be added
+     * @param in : Number of incoming edges to be added
+     */
+    void reserveEdges(size_t out, size_t in);
+
     /**
      * Auxiliary function to remove an outgoing edge (with a given destination (d)) from a vertex (this)
      *
@@ -149,10 +143,7 @@ protected:
     std::vector<Edge *> adj;        // outgoing edges
     std::vector<Edge *> incoming;   // incoming edges
     int vectorPos;                  // position in the vector of its type (citiesVector, reservoirVector, stationsVector)
-
-    // auxiliary fields
-    bool visited = false;
-    Edge *path = nullptr;
+    int index = -1;                 // position in the vertexSet of its graph
 
     /**
      * @brief Constructor for Vertex class
@@ -275,6 +266,16 @@ protected:
     double flow; // for flow-related problems
 };
 
+/**
+ * @brief An edge to be added by Graph::addEdges, by the info of its vertices
+ */
+struct EdgeSpec {
+    string orig;
+    string dest;
+    double weight;
+    bool bidirectional;
+};
+
 /* ********************* Graph  ****************************/
 /**
  * @brief Represents a Vertex in the graph.
@@ -289,14 +290,14 @@ public:
     /**
      * @brief Auxiliary function to find a vertex with a given the content.
      *
-     * Complexity: O(n)
+     * Complexity: O(|in|) expected
      */
     Vertex *findVertex(const string &in) const;
 
     /**
      *  @brief Adds a vertex with a given content or info (in) to a graph (this).
      *
-     *  Complexity: O(n)
+     *  Complexity: O(|in|) expected
      *
      *  @return Returns true if successful, and false if a vertex with that content already exists.
      */
@@ -334,6 +335,17 @@ public:
      */
     bool addBidirectionalEdge(const string &sourc, const string &dest, double w);
 
+    /**
+     * @brief Adds many edges in one pass, in their order (the same graph as calling addEdge or addBidirectionalEdge for
+     * each of them). The vertices are looked up once and their edge vectors grown once.
+     *
+     * Complexity: O(V + E) expected
+     *
+     * @param edges : Edges
+     * @return True if every edge was added, false if some refer to a vertex that does not exist (those are skipped)
+     */
+    bool addEdges(const vector<EdgeSpec> &edges);
+
     /**
      * @brief Get vertex vector
      *
@@ -343,12 +355,116 @@ public:
      */
     std::vector<Vertex *> getVertexSet() const;
 
+    /**
+     * @brief Get number of vertices
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of vertices
+     */
+    int getNumVertex() const;
+
 protected:
     std::vector<Vertex *> vertexSet;
+    unordered_map<string, Vertex *> vertexIndex;    // vertices by info
     double ** distMatrix = nullptr;
     int **pathMatrix = nullptr;
 };
 
+/* ********************* SearchState  ****************************/
+/**
+ * @brief Visited flags and path edges of one search over a graph.
+ *
+ * Kept outside the vertices, so that starting a search is O(1) and several searches can run at the same time
+ * over the same graph.
+ */
+class SearchState {
+public:
+    /**
+     * @brief Starts a new search over a graph, with every vertex unvisited
+     *
+     * Complexity: O(1) amortized
+     *
+     * @param g : Graph
+     */
+    void begin(const Graph &g);
+
+    /**
+     * @brief Check if a vertex was visited in the current search
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @return True or false
+     */
+    bool isVisited(const Vertex *v) const;
+
+    /**
+     * @brief Marks a vertex as visited
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     */
+    void setVisited(const Vertex *v);
+
+    /**
+     * @brief Get the edge through which a vertex was reached
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @return Edge
+     */
+    Edge *getPath(const Vertex *v) const;
+
+    /**
+     * @brief Set the edge through which a vertex was reached
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @param e : Edge
+     */
+    void setPath(const Vertex *v, Edge *e);
+
+    /**
+     * @brief Check if a vertex was reached from the end of a search from both ends
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @return True or false
+     */
+    bool isReached(const Vertex *v) const;
+
+    /**
+     * @brief Marks a vertex as reached from the end of a search from both ends
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @param e : Edge leading from v towards the end (nullptr for the end itself)
+     */
+    void setReached(const Vertex *v, Edge *e);
+
+    /**
+     * @brief Get the edge leading from a vertex reached from the end towards the end
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     * @return Edge
+     */
+    Edge *getToward(const Vertex *v) const;
+
+private:
+    VisitMarks visited;
+    std::vector<Edge *> path;
+    VisitMarks reached;
+    std::vector<Edge *> toward;
+};
+
 void deleteMatrix(int **m, int n);
 void deleteMatrix(double **m, int n);
 
@@ -0,0 +1,163 @@
+#include "NetworkEditor.h"
+#include "csvInfo.h"
+#include "ResultWriter.h"
+#include "TextParsing.h"
+
+/**
+ * Gets the end points of "A->B" or "A<->B".
+ */
+static bool parsePipe(const FlowNetwork &net, const string &target, FlowId &a, FlowId &b, bool &bidirectional, string &error) {
+    size_t arrow = target.find("<->");
+    size_t length = 3;
+    bidirectional = arrow != string::npos;
+    if (!bidirectional) {
+        arrow = target.find("->");
+        length = 2;
+    }
+    if (arrow == string::npos) {
+        error = "expected a pipe 'A->B' instead of '" + target + "'";
+        return false;
+    }
+    a = net.findVertex(target.substr(0, arrow));
+    b = net.findVertex(target.substr(arrow + length));
+    if (a == NO_ID || b == NO_ID) {
+        error = "unknown code in '" + target + "'";
+        return false;
+    }
+    return true;
+}
+
+static bool parseAmount(const string &value, double &amount, string &error) {
+    if (!TextParsing::parseNumber(value, amount, error)) return false;
+    if (amount < 0) {
+        error = "capacities can not be negative";
+        return false;
+    }
+    return true;
+}
+
+bool NetworkEditor::apply(FlowNetwork &net, const string &edit, string &error) {
+    stringstream tokens(edit);
+    string verb, kind, target, value, extra;
+    tokens >> verb;
+    if (verb == "add" || verb == "remove") tokens >> kind;
+    tokens >> target >> value >> extra;
+    if (!extra.empty()) {
+        error = "unexpected '" + extra + "'";
+        return false;
+    }
+
+    if (verb == "add" && kind == "station") {
+        if (target.empty() || !value.empty()) {
+            error = "expected 'add station CODE'";
+            return false;
+        }
+        if (net.addStation(target) == NO_ID) {
+            error = "code '" + target + "' already exists";
+            return false;
+        }
+        return true;    // nothing can flow through it yet
+    }
+
+    vector<FlowId> arcs;
+    double amount = 0;
+    if ((verb == "add" || verb == "remove") && kind == "pipe") {
+        FlowId a, b;
+        bool bidirectional;
+        if (!parsePipe(net, target, a, b, bidirectional, error)) return false;
+        arcs = net.findPipeArcs(a, b);
+        if (verb == "remove") {
+            if (arcs.empty()) {
+                error = "unknown pipe '" + target + "'";
+                return false;
+            }
+            if (!value.empty()) {
+                error = "unexpected '" + value + "'";
+                return false;
+            }
+        }
+        else {
+            if (!parseAmount(value, amount, error)) return false;
+            if (arcs.empty()) {
+                net.addPipe(a, b, amount, bidirectional);
+                net.maxFlow();
+                return true;
+            }
+            bool removed = true;    // restored as it was, one-way or bidirectional
+            for (FlowId arc : arcs) {
+                if (net.getCapacity(arc) > 0) removed = false;
+            }
+            if (!removed) {
+                error = "pipe '" + target + "' already exists";
+                return false;
+            }
+        }
+    }
+    else if (verb == "set") {
+        if (!parseAmount(value, amount, error)) return false;
+        if (target.find("->") != string::npos) {
+            FlowId a, b;
+            bool bidirectional;
+            if (!parsePipe(net, target, a, b, bidirectional, error)) return false;
+            arcs = net.findPipeArcs(a, b);
+            if (arcs.empty()) {
+                error = "unknown pipe '" + target + "'";
+                return false;
+            }
+        }
+        else {
+            if (net.findVertex(target) == NO_ID) {
+                error = "unknown code '" + target + "'";
+                return false;
+            }
+            Vertex* v = csvInfo::pipesGraph.findVertex(target);    // nullptr for added stations
+            if (v != nullptr && v->getType() == 1) arcs.push_back(net.getReservoirArc(v->getPos()));
+            else if (v != nullptr && v->getType() == 0) arcs.push_back(net.getCityArc(v->getPos()));
+            else {
+                error = "pumping stations have no capacity";
+                return false;
+            }
+        }
+    }
+    else {
+        error = "unknown edit '" + TextParsing::trim(edit) + "'";
+        return false;
+    }
+
+    for (FlowId arc : arcs) {
+        net.setCapacity(arc, verb == "remove" ? 0 : amount);
+    }
+    net.maxFlow();
+    return true;
+}
+
+int NetworkEditor::applyFile(const string &path, FlowNetwork &net, const string &outPath) {
+    fstream file;
+    file.open(path);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open the file." << endl;
+        return 0;
+    }
+    unique_ptr<ResultWriter> out = ResultWriter::open(outPath, {{"Line", NUMBER_COLUMN}, {"Edit", TEXT_COLUMN},
+                                                                {"MaxFlow", NUMBER_COLUMN}});
+    if (out == nullptr) return 0;
+
+    string line;
+    string error;
+    int n = 0;
+    int applied = 0;
+    while (getline(file, line)) {
+        n++;
+        line = TextParsing::trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        if (!apply(net, line, error)) {
+            cerr << "Error: line " << n << ": " << error << endl;
+            continue;
+        }
+        applied++;
+        out->add(n).add(line).add(net.getFlowValue()).endRow();
+    }
+    out->close();
+    file.close();
+    return applied;
+}
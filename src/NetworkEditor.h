@@ -0,0 +1,49 @@
+#ifndef DA2324_PRJ1_G13_4_NETWORKEDITOR_H
+#define DA2324_PRJ1_G13_4_NETWORKEDITOR_H
+
+#include "FlowNetwork.h"
+
+/**
+ * @brief Live edits of a solved network, keeping its max flow up to date after each one.
+ *
+ * Edits are written one per line:
+ *   add station CODE                  (pumping station, connected by later pipes)
+ *   add pipe A->B 100 | add pipe A<->B 100
+ *   remove pipe A->B
+ *   set A->B 100                      (pipe capacity)
+ *   set CODE 100                      (max delivery of a reservoir or demand of a city)
+ * Empty lines and lines starting with '#' are ignored. As in scenarios, a bidirectional pipe is edited in both directions.
+ *
+ * No edit re-solves from scratch. A new pipe or a higher capacity leaves the current flow valid, so the max flow only
+ * looks for the new augmenting paths. A lower capacity first reroutes or returns the water the arc can no longer carry
+ * (FlowCore::setCapacity) and then re-augments. Removed pipes stay in the network with capacity 0, and adding them
+ * again restores them.
+ */
+class NetworkEditor {
+public:
+    /**
+     * @brief Applies an edit and updates the max flow
+     *
+     * Complexity: O(V + E) per augmenting path the edit opens or breaks, usually a few
+     *
+     * @param net : Solved network
+     * @param edit : Edit
+     * @param error : What is wrong with the edit (output)
+     * @return True if the edit is valid (otherwise the network is unchanged)
+     */
+    static bool apply(FlowNetwork &net, const string &edit, string &error);
+
+    /**
+     * @brief Applies the edits of a file in order, and writes the max flow after each one to a result file
+     *
+     * Complexity: O(n (V + E)) for n edits, each opening or breaking a few augmenting paths
+     *
+     * @param path : Edits file
+     * @param net : Solved network
+     * @param outPath : Output file, without extension
+     * @return Number of edits applied
+     */
+    static int applyFile(const string &path, FlowNetwork &net, const string &outPath);
+};
+
+#endif //DA2324_PRJ1_G13_4_NETWORKEDITOR_H
@@ -0,0 +1,239 @@
+#include "NetworkReduction.h"
+#include <algorithm>
+
+template <class Cap>
+NetworkReduction<Cap>::NetworkReduction(const BasicFlowNetwork<Cap> &net) {
+    FlowId n = net.numVertices();
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        Element e;
+        e.from = net.getTail(a);
+        e.to = net.getHead(a);
+        e.capacity = net.getCapacity(a);
+        e.arc = a;
+        elements.push_back(e);
+    }
+
+    vector<bool> removed(n, false);
+    bool changed = true;
+    while (changed) {
+        changed = pruneDeadEnds(n, source, sink, removed);
+        changed = mergeParallel() || changed;
+        changed = contractRelays(n, source, sink, removed) || changed;
+    }
+
+    vector<FlowId> ids(n, NO_ID);
+    for (FlowId v = 0; v < n; v++) {
+        if (!removed[v]) ids[v] = reduced.addVertex();
+    }
+    reduced.setTerminals(ids[source], ids[sink]);
+    reducedArcs.assign(net.numArcs() / 2, NO_ID);
+    vector<FlowId> arcs;
+    for (int e = 0; e < (int) elements.size(); e++) {
+        if (!elements[e].alive) continue;
+        FlowId r = reduced.addArc(ids[elements[e].from], ids[elements[e].to], elements[e].capacity);
+        reducedElements.push_back(e);
+        arcs.clear();
+        collectArcs(e, arcs);
+        for (FlowId a : arcs) reducedArcs[a / 2] = r;
+    }
+}
+
+template <class Cap>
+bool NetworkReduction<Cap>::pruneDeadEnds(FlowId n, FlowId source, FlowId sink, vector<bool> &removed) {
+    // elements of positive capacity leaving (out) and entering (in) each vertex, as CSR
+    vector<FlowId> outStart(n + 1, 0), inStart(n + 1, 0);
+    for (const Element &e : elements) {
+        if (!e.alive || e.capacity <= 0) continue;
+        outStart[e.from + 1]++;
+        inStart[e.to + 1]++;
+    }
+    for (FlowId v = 0; v < n; v++) {
+        outStart[v + 1] += outStart[v];
+        inStart[v + 1] += inStart[v];
+    }
+    vector<FlowId> outHeads(outStart[n]), inTails(inStart[n]);
+    vector<FlowId> outPos(outStart.begin(), outStart.end() - 1), inPos(inStart.begin(), inStart.end() - 1);
+    for (const Element &e : elements) {
+        if (!e.alive || e.capacity <= 0) continue;
+        outHeads[outPos[e.from]++] = e.to;
+        inTails[inPos[e.to]++] = e.from;
+    }
+
+    auto search = [n](FlowId from, const vector<FlowId> &start, const vector<FlowId> &adj) {
+        vector<bool> seen(n, false);
+        vector<FlowId> queue = {from};
+        seen[from] = true;
+        for (size_t i = 0; i < queue.size(); i++) {
+            for (FlowId k = start[queue[i]]; k < start[queue[i] + 1]; k++) {
+                if (seen[adj[k]]) continue;
+                seen[adj[k]] = true;
+                queue.push_back(adj[k]);
+            }
+        }
+        return seen;
+    };
+    vector<bool> reached = search(source, outStart, outHeads);
+    vector<bool> reaching = search(sink, inStart, inTails);
+
+    bool changed = false;
+    for (FlowId v = 0; v < n; v++) {
+        if (removed[v] || v == source || v == sink || (reached[v] && reaching[v])) continue;
+        removed[v] = true;
+        deadEnds++;
+        changed = true;
+    }
+    for (Element &e : elements) {
+        if (!e.alive || (e.capacity > 0 && reached[e.from] && reaching[e.to])) continue;
+        e.alive = false;
+        changed = true;
+    }
+    return changed;
+}
+
+template <class Cap>
+bool NetworkReduction<Cap>::mergeParallel() {
+    vector<int> order;
+    for (int e = 0; e < (int) elements.size(); e++) {
+        if (elements[e].alive) order.push_back(e);
+    }
+    sort(order.begin(), order.end(), [this](int a, int b) {
+        if (elements[a].from != elements[b].from) return elements[a].from < elements[b].from;
+        if (elements[a].to != elements[b].to) return elements[a].to < elements[b].to;
+        return a < b;
+    });
+
+    bool changed = false;
+    for (size_t i = 0; i < order.size();) {
+        size_t j = i + 1;
+        while (j < order.size() && elements[order[j]].from == elements[order[i]].from && elements[order[j]].to == elements[order[i]].to) j++;
+        if (j - i > 1) {
+            Element merged;
+            merged.kind = PARALLEL_ELEMENT;
+            merged.from = elements[order[i]].from;
+            merged.to = elements[order[i]].to;
+            for (size_t k = i; k < j; k++) {
+                Element &e = elements[order[k]];
+                merged.capacity += e.capacity;
+                if (e.kind == PARALLEL_ELEMENT) merged.children.insert(merged.children.end(), e.children.begin(), e.children.end());
+                else merged.children.push_back(order[k]);
+                e.alive = false;
+            }
+            mergedParallel += (int) (j - i - 1);
+            elements.push_back(merged);
+            changed = true;
+        }
+        i = j;
+    }
+    return changed;
+}
+
+template <class Cap>
+bool NetworkReduction<Cap>::contractRelays(FlowId n, FlowId source, FlowId sink, vector<bool> &removed) {
+    vector<int> inCount(n, 0), outCount(n, 0), in(n, -1), out(n, -1);
+    for (int e = 0; e < (int) elements.size(); e++) {
+        if (!elements[e].alive) continue;
+        outCount[elements[e].from]++;
+        out[elements[e].from] = e;
+        inCount[elements[e].to]++;
+        in[elements[e].to] = e;
+    }
+
+    bool changed = false;
+    for (FlowId v = 0; v < n; v++) {
+        if (removed[v] || v == source || v == sink || inCount[v] != 1 || outCount[v] != 1) continue;
+        int i = in[v];
+        int o = out[v];
+        if (!elements[i].alive || !elements[o].alive) continue;    // already contracted in this round
+        removed[v] = true;
+        elements[i].alive = false;
+        elements[o].alive = false;
+        changed = true;
+        if (elements[i].from == elements[o].to) {    // u -> v -> u, water can only go back
+            deadEnds++;
+            continue;
+        }
+
+        Element series;
+        series.kind = SERIES_ELEMENT;
+        series.from = elements[i].from;
+        series.to = elements[o].to;
+        series.capacity = min(elements[i].capacity, elements[o].capacity);
+        for (int c : {i, o}) {
+            if (elements[c].kind == SERIES_ELEMENT) series.children.insert(series.children.end(), elements[c].children.begin(), elements[c].children.end());
+            else series.children.push_back(c);
+        }
+        contractedRelays++;
+        elements.push_back(series);
+    }
+    return changed;
+}
+
+template <class Cap>
+FlowCore<Cap> &NetworkReduction<Cap>::getReduced() {
+    return reduced;
+}
+
+template <class Cap>
+FlowId NetworkReduction<Cap>::getReducedArc(FlowId a) const {
+    return reducedArcs[a / 2];
+}
+
+template <class Cap>
+vector<FlowId> NetworkReduction<Cap>::getOriginalArcs(FlowId r) const {
+    vector<FlowId> arcs;
+    collectArcs(reducedElements[r / 2], arcs);
+    return arcs;
+}
+
+template <class Cap>
+int NetworkReduction<Cap>::getDeadEnds() const {
+    return deadEnds;
+}
+
+template <class Cap>
+int NetworkReduction<Cap>::getContractedRelays() const {
+    return contractedRelays;
+}
+
+template <class Cap>
+int NetworkReduction<Cap>::getMergedParallel() const {
+    return mergedParallel;
+}
+
+template <class Cap>
+void NetworkReduction<Cap>::expandFlow(BasicFlowNetwork<Cap> &net) const {
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        net.setFlow(a, 0);
+    }
+    for (FlowId r = 0; r < reduced.numArcs(); r += 2) {
+        expand(reducedElements[r / 2], reduced.getFlow(r), net);
+    }
+}
+
+template <class Cap>
+void NetworkReduction<Cap>::expand(int e, Cap f, BasicFlowNetwork<Cap> &net) const {
+    const Element &element = elements[e];
+    if (element.kind == ARC_ELEMENT) net.setFlow(element.arc, f);
+    else if (element.kind == SERIES_ELEMENT) {
+        for (int c : element.children) expand(c, f, net);
+    }
+    else {
+        for (int c : element.children) {
+            Cap part = min(f, elements[c].capacity);
+            expand(c, part, net);
+            f -= part;
+        }
+    }
+}
+
+template <class Cap>
+void NetworkReduction<Cap>::collectArcs(int e, vector<FlowId> &arcs) const {
+    if (elements[e].kind == ARC_ELEMENT) arcs.push_back(elements[e].arc);
+    for (int c : elements[e].children) collectArcs(c, arcs);
+}
+
+template class NetworkReduction<int32_t>;
+template class NetworkReduction<int64_t>;
+template class NetworkReduction<double>;
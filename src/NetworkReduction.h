@@ -0,0 +1,178 @@
+#ifndef DA2324_PRJ1_G13_4_NETWORKREDUCTION_H
+#define DA2324_PRJ1_G13_4_NETWORKREDUCTION_H
+
+#include "FlowNetwork.h"
+
+/**
+ * @brief Smaller network with the same max flow, and the mapping from its arcs back to the pipes they stand for.
+ *
+ * Three rules are applied until none changes anything:
+ * - Dead ends: vertices that can not be reached from the source or can not reach the sink (through arcs of positive
+ *   capacity) are dropped with their arcs, as no water can go through them.
+ * - Parallel arcs u -> w are merged into one (capacity = sum).
+ * - A vertex other than the terminals with exactly one arc in, u -> v, and one out, v -> w (u != w), only relays
+ *   water: both are contracted into u -> w (capacity = min).
+ * Each arc of the reduced network is thus a tree of series and parallel compositions of original arcs. Flows found on
+ * the reduced network are expanded onto the original arcs by giving every member of a series the flow of the series,
+ * and filling the members of a parallel composition in order.
+ */
+template <class Cap>
+class NetworkReduction {
+public:
+    /**
+     * @brief Reduces a network
+     *
+     * Complexity: O(k E log E), k = number of rounds (at most the length of the longest chain)
+     *
+     * @param net : Network
+     */
+    explicit NetworkReduction(const BasicFlowNetwork<Cap> &net);
+
+    /**
+     * @brief Get the reduced network, with no flow until it is solved
+     *
+     * Complexity: O(1)
+     *
+     * @return Reduced network
+     */
+    FlowCore<Cap> &getReduced();
+
+    /**
+     * @brief Get the arc of the reduced network that carries an original arc
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc of the original network (not a residual twin)
+     * @return Reduced arc, or NO_ID if the arc was dropped
+     */
+    FlowId getReducedArc(FlowId a) const;
+
+    /**
+     * @brief Get the original arcs a reduced arc stands for
+     *
+     * Complexity: O(size of the answer)
+     *
+     * @param r : Arc of the reduced network (not a residual twin)
+     * @return Arcs of the original network
+     */
+    vector<FlowId> getOriginalArcs(FlowId r) const;
+
+    /**
+     * @brief Get number of vertices dropped as dead ends
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of vertices
+     */
+    int getDeadEnds() const;
+
+    /**
+     * @brief Get number of relay vertices contracted
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of vertices
+     */
+    int getContractedRelays() const;
+
+    /**
+     * @brief Get number of arcs removed by merging parallel arcs
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of arcs
+     */
+    int getMergedParallel() const;
+
+    /**
+     * @brief Copies the flow of the reduced network onto the original one. Arcs that were dropped get no flow.
+     *
+     * Complexity: O(V + E)
+     *
+     * @param net : Network this reduction was made from
+     */
+    void expandFlow(BasicFlowNetwork<Cap> &net) const;
+
+private:
+    enum ElementKind { ARC_ELEMENT, SERIES_ELEMENT, PARALLEL_ELEMENT };
+
+    /**
+     * @brief Original arc, or series or parallel composition of other elements
+     */
+    class Element {
+    public:
+        ElementKind kind = ARC_ELEMENT;
+        FlowId from = NO_ID;
+        FlowId to = NO_ID;
+        Cap capacity = 0;
+        FlowId arc = NO_ID;
+        vector<int> children;
+        bool alive = true;
+    };
+
+    vector<Element> elements;
+    FlowCore<Cap> reduced;
+    vector<int> reducedElements;    // element of each reduced arc / 2
+    vector<FlowId> reducedArcs;     // reduced arc of each original arc / 2
+    int deadEnds = 0;
+    int contractedRelays = 0;
+    int mergedParallel = 0;
+
+    /**
+     * @brief Drops the vertices that are not between the source and the sink
+     *
+     * Complexity: O(V + E)
+     *
+     * @param n : Number of vertices
+     * @param source : Source
+     * @param sink : Sink
+     * @param removed : Whether each vertex was removed (updated)
+     * @return True if anything was dropped
+     */
+    bool pruneDeadEnds(FlowId n, FlowId source, FlowId sink, vector<bool> &removed);
+
+    /**
+     * @brief Merges the parallel elements
+     *
+     * Complexity: O(E log E)
+     *
+     * @return True if anything was merged
+     */
+    bool mergeParallel();
+
+    /**
+     * @brief Contracts the vertices with exactly one element in and one out
+     *
+     * Complexity: O(V + E)
+     *
+     * @param n : Number of vertices
+     * @param source : Source
+     * @param sink : Sink
+     * @param removed : Whether each vertex was removed (updated)
+     * @return True if anything was contracted
+     */
+    bool contractRelays(FlowId n, FlowId source, FlowId sink, vector<bool> &removed);
+
+    /**
+     * @brief Gives an element and its members a flow
+     *
+     * Complexity: O(size of the element)
+     *
+     * @param e : Element
+     * @param f : Flow
+     * @param net : Original network
+     */
+    void expand(int e, Cap f, BasicFlowNetwork<Cap> &net) const;
+
+    /**
+     * @brief Collects the original arcs of an element
+     *
+     * Complexity: O(size of the element)
+     *
+     * @param e : Element
+     * @param arcs : Arcs (output)
+     */
+    void collectArcs(int e, vector<FlowId> &arcs) const;
+};
+
+#endif //DA2324_PRJ1_G13_4_NETWORKREDUCTION_H
@@ -0,0 +1,133 @@
+#include "NetworkRegions.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+static FlowId findRoot(vector<FlowId> &parent, FlowId v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];    // path halving
+        v = parent[v];
+    }
+    return v;
+}
+
+NetworkRegions::NetworkRegions() = default;
+
+template <class Cap>
+NetworkRegions::NetworkRegions(const FlowCore<Cap> &net) {
+    FlowId n = net.numVertices();
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+
+    vector<FlowId> parent(n);
+    vector<FlowId> height(n, 0);
+    for (FlowId v = 0; v < n; v++) parent[v] = v;
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        FlowId u = net.getTail(a);
+        FlowId v = net.getHead(a);
+        if (u == source || u == sink || v == source || v == sink) continue;
+        u = findRoot(parent, u);
+        v = findRoot(parent, v);
+        if (u == v) continue;
+        if (height[u] < height[v]) swap(u, v);
+        parent[v] = u;
+        if (height[u] == height[v]) height[u]++;
+    }
+
+    vector<int> rootRegion(n, -1);
+    vertexRegions.assign(n, -1);
+    for (FlowId v = 0; v < n; v++) {
+        if (v == source || v == sink) continue;
+        FlowId root = findRoot(parent, v);
+        if (rootRegion[root] < 0) {
+            rootRegion[root] = (int) sizes.size();
+            sizes.push_back(0);
+        }
+        vertexRegions[v] = rootRegion[root];
+        sizes[vertexRegions[v]]++;
+    }
+
+    arcRegions.assign(net.numArcs(), -1);
+    for (FlowId a = 0; a < net.numArcs(); a++) {
+        FlowId u = net.getTail(a);
+        arcRegions[a] = u == source || u == sink ? vertexRegions[net.getHead(a)] : vertexRegions[u];
+    }
+
+    sourceStart.assign(sizes.size() + 1, 0);
+    if (source == NO_ID) return;
+    for (FlowId a = net.firstArc(source); a != NO_ID; a = net.nextArc(a)) {
+        if (arcRegions[a] >= 0) sourceStart[arcRegions[a] + 1]++;
+    }
+    for (size_t r = 0; r < sizes.size(); r++) sourceStart[r + 1] += sourceStart[r];
+    sourceArcs.resize(sourceStart.back());
+    vector<FlowId> pos(sourceStart.begin(), sourceStart.end() - 1);
+    for (FlowId a = net.firstArc(source); a != NO_ID; a = net.nextArc(a)) {
+        if (arcRegions[a] >= 0) sourceArcs[pos[arcRegions[a]]++] = a;
+        else if (net.getHead(a) == sink && (a & 1) == 0) directArcs.push_back(a);
+    }
+}
+
+int NetworkRegions::numRegions() const {
+    return (int) sizes.size();
+}
+
+int NetworkRegions::getRegion(FlowId v) const {
+    return vertexRegions[v];
+}
+
+int NetworkRegions::getArcRegion(FlowId a) const {
+    return arcRegions[a];
+}
+
+FlowId NetworkRegions::getRegionSize(int r) const {
+    return sizes[r];
+}
+
+template <class Cap>
+Cap NetworkRegions::solveRegion(FlowCore<Cap> &net, int r) const {
+    return net.maxFlowThrough(sourceArcs.data() + sourceStart[r], sourceArcs.data() + sourceStart[r + 1]);
+}
+
+template <class Cap>
+Cap NetworkRegions::solve(FlowCore<Cap> &net, unsigned threads) const {
+    // largest regions first, so that they do not end up last on one thread
+    vector<int> order;
+    for (int r = 0; r < numRegions(); r++) {
+        if (sourceStart[r + 1] > sourceStart[r]) order.push_back(r);
+    }
+    sort(order.begin(), order.end(), [this](int a, int b) { return sizes[a] > sizes[b]; });
+
+    // arcs straight from the source to the sink (left by NetworkReduction) are in no region and simply saturated
+    for (FlowId a : directArcs) {
+        net.setFlow(a, net.getCapacity(a));
+    }
+
+    if (threads == 0) threads = max(1u, std::thread::hardware_concurrency());
+    threads = min(threads, (unsigned) max((size_t) 1, order.size()));
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < order.size(); i = next++) {
+            solveRegion(net, order[i]);
+        }
+    };
+
+    vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &t : pool) {
+        t.join();
+    }
+    return net.getFlowValue();
+}
+
+template NetworkRegions::NetworkRegions(const FlowCore<int32_t> &net);
+template NetworkRegions::NetworkRegions(const FlowCore<int64_t> &net);
+template NetworkRegions::NetworkRegions(const FlowCore<double> &net);
+template int32_t NetworkRegions::solve(FlowCore<int32_t> &net, unsigned threads) const;
+template int64_t NetworkRegions::solve(FlowCore<int64_t> &net, unsigned threads) const;
+template double NetworkRegions::solve(FlowCore<double> &net, unsigned threads) const;
+template int32_t NetworkRegions::solveRegion(FlowCore<int32_t> &net, int r) const;
+template int64_t NetworkRegions::solveRegion(FlowCore<int64_t> &net, int r) const;
+template double NetworkRegions::solveRegion(FlowCore<double> &net, int r) const;
@@ -0,0 +1,109 @@
+#ifndef DA2324_PRJ1_G13_4_NETWORKREGIONS_H
+#define DA2324_PRJ1_G13_4_NETWORKREGIONS_H
+
+#include "FlowNetwork.h"
+
+/**
+ * @brief Independent regional systems of a network: the weakly connected components left by removing the super source
+ * and super sink.
+ *
+ * No water can move from one region to another, so the max flow of a network is the sum of the max flows of its
+ * regions, each of which can be solved by its own thread (FlowCore::maxFlowThrough), and a change in one region only
+ * needs that region to be re-solved. Components are found with union-find over the arcs.
+ */
+class NetworkRegions {
+public:
+    /**
+     * @brief Default constructor, no regions
+     *
+     * Complexity: O(1)
+     */
+    NetworkRegions();
+
+    /**
+     * @brief Finds the regions of a network
+     *
+     * Complexity: O((V + E) α(V))
+     *
+     * @param net : Network
+     */
+    template <class Cap>
+    explicit NetworkRegions(const FlowCore<Cap> &net);
+
+    /**
+     * @brief Get number of regions
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of regions
+     */
+    int numRegions() const;
+
+    /**
+     * @brief Get the region of a vertex
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex id
+     * @return Region, or -1 for the super source and super sink
+     */
+    int getRegion(FlowId v) const;
+
+    /**
+     * @brief Get the region of an arc (the region of its end that is not a terminal)
+     *
+     * Complexity: O(1)
+     *
+     * @param a : Arc id
+     * @return Region, or -1 for an arc between the terminals
+     */
+    int getArcRegion(FlowId a) const;
+
+    /**
+     * @brief Get the number of vertices of a region
+     *
+     * Complexity: O(1)
+     *
+     * @param r : Region
+     * @return Number of vertices
+     */
+    FlowId getRegionSize(int r) const;
+
+    /**
+     * @brief Solves the max flow of every region over a pool of threads, starting from the current flow. Arcs from the
+     * source straight to the sink are saturated.
+     *
+     * Complexity: O(sum of V_r E_r^2 / threads)
+     *
+     * @param net : Network the regions were found in
+     * @param threads : Number of threads (0 for one per hardware thread)
+     * @return Max flow
+     */
+    template <class Cap>
+    Cap solve(FlowCore<Cap> &net, unsigned threads = 0) const;
+
+    /**
+     * @brief Re-solves the max flow of one region, starting from the current flow
+     *
+     * Complexity: O(V_r E_r^2)
+     *
+     * @param net : Network the regions were found in
+     * @param r : Region
+     * @return Flow delivered by the region
+     */
+    template <class Cap>
+    Cap solveRegion(FlowCore<Cap> &net, int r) const;
+
+private:
+    vector<int> vertexRegions;
+    vector<int> arcRegions;
+    vector<FlowId> sizes;
+
+    // arcs leaving the source of each region, region r in [sourceStart[r], sourceStart[r + 1])
+    vector<FlowId> sourceStart;
+    vector<FlowId> sourceArcs;
+
+    vector<FlowId> directArcs;    // arcs from the source straight to the sink, in no region
+};
+
+#endif //DA2324_PRJ1_G13_4_NETWORKREGIONS_H
@@ -0,0 +1,226 @@
+#include "NetworkStats.h"
+#include "csvInfo.h"
+#include <algorithm>
+#include <map>
+
+/**
+ * @brief Welford's running mean and sum of squared deviations
+ */
+struct RunningStats {
+    double count = 0;
+    double mean = 0;
+    double m2 = 0;
+    double max = 0;
+
+    void add(double x) {
+        count++;
+        double d = x - mean;
+        mean += d / count;
+        m2 += d * (x - mean);
+        max = std::max(max, x);
+    }
+
+    void merge(const RunningStats &other) {
+        if (other.count == 0) return;
+        double total = count + other.count;
+        double d = other.mean - mean;
+        mean += d * other.count / total;
+        m2 += other.m2 + d * d * count * other.count / total;
+        max = std::max(max, other.max);
+        count = total;
+    }
+
+    void store(PipeStats &s) const {
+        s.count = (size_t) count;
+        s.mean = mean;
+        s.variance = count > 0 ? m2 / count : 0;
+        s.max = max;
+    }
+};
+
+/**
+ * @brief Fills the percentiles of a range of residuals, reordering it
+ *
+ * Complexity: O(n)
+ *
+ * @param begin : First residual
+ * @param end : Past the last residual
+ * @param s : Statistics to fill
+ */
+static void findPercentiles(vector<double>::iterator begin, vector<double>::iterator end, PipeStats &s) {
+    size_t n = end - begin;
+    if (n == 0) return;
+    auto rank = [&](size_t percent) { return begin + (ptrdiff_t) ((n * percent + 99) / 100 - 1); };
+    // each percentile is searched for above the previous one only
+    auto median = rank(50), p90 = rank(90), p99 = rank(99);
+    nth_element(begin, median, end);
+    nth_element(median, p90, end);
+    nth_element(p90, p99, end);
+    s.median = *median;
+    s.p90 = *p90;
+    s.p99 = *p99;
+}
+
+NetworkStats NetworkStats::fromPipes(const vector<double> &capacity, const vector<double> &flow,
+                                     const vector<int> &municipality, const vector<string> &names) {
+    NetworkStats stats;
+    size_t n = capacity.size();
+    vector<double> residual(n);
+
+    // interleaved lanes with no dependency between them, merged below
+    const size_t LANES = 4;
+    double laneMean[LANES] = {}, laneM2[LANES] = {}, laneMax[LANES] = {};
+    size_t blocks = n / LANES;
+    for (size_t b = 0; b < blocks; b++) {
+        double inverse = 1.0 / (double) (b + 1);
+        for (size_t l = 0; l < LANES; l++) {
+            size_t i = b * LANES + l;
+            double x = capacity[i] - flow[i];
+            residual[i] = x;
+            double d = x - laneMean[l];
+            laneMean[l] += d * inverse;
+            laneM2[l] += d * (x - laneMean[l]);
+            laneMax[l] = std::max(laneMax[l], x);
+        }
+    }
+    RunningStats overall;
+    for (size_t l = 0; l < LANES && blocks > 0; l++) {
+        RunningStats lane;
+        lane.count = (double) blocks;
+        lane.mean = laneMean[l];
+        lane.m2 = laneM2[l];
+        lane.max = laneMax[l];
+        overall.merge(lane);
+    }
+    for (size_t i = blocks * LANES; i < n; i++) {
+        residual[i] = capacity[i] - flow[i];
+        overall.add(residual[i]);
+    }
+    overall.store(stats.overall);
+
+    // municipalities and histograms
+    stats.municipalities = names;
+    stats.byMunicipality.assign(names.size(), PipeStats());
+    vector<RunningStats> running(names.size());
+    vector<size_t> start(names.size() + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        int bucket = capacity[i] > 0 ? (int) (flow[i] / capacity[i] * UTILIZATION_BUCKETS) : 0;
+        bucket = max(0, min(bucket, UTILIZATION_BUCKETS - 1));
+        stats.overall.histogram[bucket]++;
+        int m = municipality[i];
+        if (m < 0) continue;
+        running[m].add(residual[i]);
+        stats.byMunicipality[m].histogram[bucket]++;
+        start[m + 1]++;
+    }
+    for (size_t m = 0; m < names.size(); m++) {
+        running[m].store(stats.byMunicipality[m]);
+        start[m + 1] += start[m];
+    }
+
+    // residuals grouped by municipality (counting sort), then the percentiles of each group
+    vector<double> grouped(start.back());
+    vector<size_t> position(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+        if (municipality[i] >= 0) grouped[position[municipality[i]]++] = residual[i];
+    }
+    for (size_t m = 0; m < names.size(); m++) {
+        findPercentiles(grouped.begin() + (ptrdiff_t) start[m], grouped.begin() + (ptrdiff_t) start[m + 1], stats.byMunicipality[m]);
+    }
+    findPercentiles(residual.begin(), residual.end(), stats.overall);
+    return stats;
+}
+
+/**
+ * @brief Numbers the municipalities of the cities and reservoirs in alphabetical order
+ *
+ * Complexity: O((C + R) log m), m = municipalities
+ *
+ * @param names : Name of each municipality (output)
+ * @return Number of each municipality
+ */
+static map<string, int> municipalityIds(vector<string> &names) {
+    map<string, int> ids;
+    for (City c : csvInfo::citiesVector) ids[c.getCity()] = 0;
+    for (Reservoir r : csvInfo::reservoirsVector) ids[r.getMunicipality()] = 0;
+    for (auto &entry : ids) {
+        entry.second = (int) names.size();
+        names.push_back(entry.first);
+    }
+    return ids;
+}
+
+NetworkStats NetworkStats::fromPipesGraph() {
+    vector<string> names;
+    map<string, int> ids = municipalityIds(names);
+    auto municipalityOf = [&](const Edge *e) {
+        for (Vertex *v : {e->getDest(), e->getOrig()}) {
+            if (v->getType() == 0) return ids[csvInfo::citiesVector[v->getPos()].getCity()];
+        }
+        for (Vertex *v : {e->getOrig(), e->getDest()}) {
+            if (v->getType() == 1) return ids[csvInfo::reservoirsVector[v->getPos()].getMunicipality()];
+        }
+        return -1;
+    };
+
+    double maxFlow = 0;
+    vector<double> capacity, flow;
+    vector<int> municipality;
+    for (Vertex *v : csvInfo::pipesGraph.getVertexSet()) {
+        if (v->getType() == 0) {
+            for (Edge *e : v->getIncoming()) maxFlow += e->getFlow();
+        }
+        for (Edge *e : v->getAdj()) {
+            if (e->getFlow() == 0 && e->getReverse() != nullptr) continue;
+            capacity.push_back(e->getWeight());
+            flow.push_back(e->getFlow());
+            municipality.push_back(municipalityOf(e));
+        }
+    }
+
+    NetworkStats stats = fromPipes(capacity, flow, municipality, names);
+    stats.maxFlow = maxFlow;
+    return stats;
+}
+
+NetworkStats NetworkStats::fromFlowNetwork(const FlowNetwork &net) {
+    vector<string> names;
+    map<string, int> ids = municipalityIds(names);
+    vector<int> cityMunicipality(net.numVertices(), -1);
+    vector<int> reservoirMunicipality(net.numVertices(), -1);
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        FlowId a = net.getCityArc(i);
+        if (a != NO_ID) cityMunicipality[net.getTail(a)] = ids[csvInfo::citiesVector[i].getCity()];
+    }
+    for (int i = 0; i < (int) csvInfo::reservoirsVector.size(); i++) {
+        FlowId a = net.getReservoirArc(i);
+        if (a != NO_ID) reservoirMunicipality[net.getHead(a)] = ids[csvInfo::reservoirsVector[i].getMunicipality()];
+    }
+    auto municipalityOf = [&](FlowId a) {
+        for (FlowId v : {net.getHead(a), net.getTail(a)}) {
+            if (cityMunicipality[v] >= 0) return cityMunicipality[v];
+        }
+        for (FlowId v : {net.getTail(a), net.getHead(a)}) {
+            if (reservoirMunicipality[v] >= 0) return reservoirMunicipality[v];
+        }
+        return -1;
+    };
+
+    vector<double> capacity, flow;
+    vector<int> municipality;
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        if (!net.isPipe(a) || net.getCapacity(a) == 0) continue;
+        if (net.getFlow(a) == 0 && net.isBidirectional(a)) continue;
+        capacity.push_back(net.getCapacity(a));
+        flow.push_back(net.getFlow(a));
+        municipality.push_back(municipalityOf(a));
+    }
+
+    NetworkStats stats = fromPipes(capacity, flow, municipality, names);
+    for (double f : net.getCityFlows()) stats.maxFlow += f;
+    return stats;
+}
+
+vector<double> NetworkStats::getMetrics() const {
+    return {maxFlow, overall.mean, overall.variance, overall.max, overall.median, overall.p90, overall.p99};
+}
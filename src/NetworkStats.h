@@ -0,0 +1,129 @@
+#ifndef DA2324_PRJ1_G13_4_NETWORKSTATS_H
+#define DA2324_PRJ1_G13_4_NETWORKSTATS_H
+
+#include <string>
+#include <vector>
+#include "FlowNetwork.h"
+using namespace std;
+
+/**
+ * @brief Number of utilization classes of the histograms: [0, 10%), [10%, 20%), ..., [90%, 100%]
+ */
+const int UTILIZATION_BUCKETS = 10;
+
+/**
+ * @brief Statistics of the residual capacity (capacity - flow) of a set of pipes
+ */
+class PipeStats {
+public:
+    /**
+     * @brief Number of pipes
+     */
+    size_t count = 0;
+
+    /**
+     * @brief Mean residual capacity
+     */
+    double mean = 0;
+
+    /**
+     * @brief Variance of the residual capacity (population)
+     */
+    double variance = 0;
+
+    /**
+     * @brief Largest residual capacity
+     */
+    double max = 0;
+
+    /**
+     * @brief Residual capacity percentiles (nearest rank)
+     */
+    double median = 0, p90 = 0, p99 = 0;
+
+    /**
+     * @brief Pipes in each utilization (flow / capacity) class
+     */
+    vector<size_t> histogram = vector<size_t>(UTILIZATION_BUCKETS, 0);
+};
+
+/**
+ * @brief Balance statistics of the pipes of a network, overall and per municipality.
+ *
+ * The pipes are first packed into flat capacity / flow arrays. The mean and variance come from Welford's recurrence,
+ * run over a few interleaved lanes that are merged at the end (Chan et al.), so the loop has no dependency from one
+ * pipe to the next and can be vectorized. The municipality accumulators and the histograms are filled in the same pass,
+ * and the percentiles come from nth_element on the residuals grouped by municipality, O(n) overall.
+ *
+ * A pipe belongs to the municipality of the city it delivers to, or else of the reservoir it leaves. Pipes between
+ * stations only count for the overall figures.
+ */
+class NetworkStats {
+public:
+    /**
+     * @brief Water reaching the cities
+     */
+    double maxFlow = 0;
+
+    /**
+     * @brief Every pipe
+     */
+    PipeStats overall;
+
+    /**
+     * @brief Municipalities, in alphabetical order
+     */
+    vector<string> municipalities;
+
+    /**
+     * @brief Pipes of each municipality
+     */
+    vector<PipeStats> byMunicipality;
+
+    /**
+     * @brief Computes the statistics of the current flow of csvInfo::pipesGraph. Unused directions of bidirectional
+     * pipes are left out.
+     *
+     * Complexity: O(V + E)
+     *
+     * @return Statistics
+     */
+    static NetworkStats fromPipesGraph();
+
+    /**
+     * @brief Computes the statistics of the current flow of a network, edits included. As in fromPipesGraph, unused
+     * directions of bidirectional pipes are left out, and so are removed pipes (capacity 0).
+     *
+     * Complexity: O(V + E)
+     *
+     * @param net : Network
+     * @return Statistics
+     */
+    static NetworkStats fromFlowNetwork(const FlowNetwork &net);
+
+    /**
+     * @brief Computes the statistics of packed pipes
+     *
+     * Complexity: O(n + m), m = municipalities
+     *
+     * @param capacity : Capacity of each pipe
+     * @param flow : Flow of each pipe
+     * @param municipality : Municipality of each pipe, or -1
+     * @param names : Name of each municipality
+     * @return Statistics (maxFlow is left 0)
+     */
+    static NetworkStats fromPipes(const vector<double> &capacity, const vector<double> &flow,
+                                  const vector<int> &municipality, const vector<string> &names);
+
+    /**
+     * @brief Get the figures compared by the balance report: max flow, mean, variance, max, median, 90th and 99th
+     * percentile
+     *
+     * Complexity: O(1)
+     *
+     * @return Metrics vector
+     */
+    vector<double> getMetrics() const;
+};
+
+#endif //DA2324_PRJ1_G13_4_NETWORKSTATS_H
@@ -0,0 +1,366 @@
+#include "Pseudoflow.h"
+#include <algorithm>
+
+template <class Cap>
+Pseudoflow<Cap>::Pseudoflow(FlowCore<Cap> &net, PseudoflowVariant variant): net(net), variant(variant) {}
+
+template <class Cap>
+int Pseudoflow<Cap>::getMergers() const {
+    return mergers;
+}
+
+template <class Cap>
+int Pseudoflow<Cap>::getRelabels() const {
+    return relabels;
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::link(FlowId v, FlowId p, FlowId a) {
+    parent[v] = p;
+    parentArc[v] = a;
+    prevSibling[v] = NO_ID;
+    nextSibling[v] = firstChild[p];
+    if (firstChild[p] != NO_ID) prevSibling[firstChild[p]] = v;
+    firstChild[p] = v;
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::cut(FlowId v) {
+    FlowId p = parent[v];
+    if (prevSibling[v] != NO_ID) nextSibling[prevSibling[v]] = nextSibling[v];
+    else firstChild[p] = nextSibling[v];
+    if (nextSibling[v] != NO_ID) prevSibling[nextSibling[v]] = prevSibling[v];
+    if (nextScan[p] == v) nextScan[p] = nextSibling[v];
+    parent[v] = NO_ID;
+    parentArc[v] = NO_ID;
+    prevSibling[v] = NO_ID;
+    nextSibling[v] = NO_ID;
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::addStrongRoot(FlowId r) {
+    if (labels[r] >= n) return;    // can not reach a weak vertex any more
+    buckets[labels[r]].push_back(r);
+    if (order == LOWEST_LABEL ? labels[r] < bucket : labels[r] > bucket) bucket = labels[r];
+}
+
+template <class Cap>
+FlowId Pseudoflow<Cap>::nextStrongRoot() {
+    while (bucket < n) {
+        vector<FlowId> &roots = buckets[bucket];
+        while (!roots.empty()) {
+            FlowId r = roots.back();
+            roots.pop_back();
+            if (parent[r] != NO_ID || labels[r] != bucket || excess[r] <= FlowCore<Cap>::epsilon()) continue;
+            if (bucket == 0 || labelCount[bucket - 1] > 0) return r;
+            // gap: no vertex one label lower, so no merger arc can ever be found for it
+            labelCount[bucket]--;
+            labels[r] = n;
+        }
+        if (order == LOWEST_LABEL) bucket++;
+        else if (bucket-- == 0) break;
+    }
+    return NO_ID;
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::initialize() {
+    n = net.numVertices();
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    mergers = 0;
+    relabels = 0;
+
+    for (FlowId a = net.firstArc(source); a != NO_ID; a = net.nextArc(a)) {
+        net.setFlow(a, net.getCapacity(a));
+    }
+    for (FlowId a = net.firstArc(sink); a != NO_ID; a = net.nextArc(a)) {
+        net.setFlow(a ^ 1, net.getCapacity(a ^ 1));
+    }
+
+    excess.assign(n, 0);
+    labels.assign(n, 0);
+    currentArc.resize(n);
+    parent.assign(n, NO_ID);
+    parentArc.assign(n, NO_ID);
+    firstChild.assign(n, NO_ID);
+    nextSibling.assign(n, NO_ID);
+    prevSibling.assign(n, NO_ID);
+    nextScan.assign(n, NO_ID);
+    buckets.assign(n, vector<FlowId>());
+    order = variant;
+    bucket = order == LOWEST_LABEL ? n : 0;
+
+    for (FlowId v = 0; v < n; v++) {
+        currentArc[v] = net.firstArc(v);
+        for (FlowId a = net.firstArc(v); a != NO_ID; a = net.nextArc(a)) {
+            excess[v] -= net.getFlow(a);    // the twin of each arc into v carries minus its flow
+        }
+    }
+    labels[source] = labels[sink] = n;
+    labelCount.assign(n + 1, 0);
+    for (FlowId v = 0; v < n; v++) {
+        if (v == source || v == sink) continue;
+        if (excess[v] > FlowCore<Cap>::epsilon()) {
+            labels[v] = 1;
+            addStrongRoot(v);
+        }
+        labelCount[labels[v]]++;
+    }
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::restartLowest() {
+    order = LOWEST_LABEL;
+    bucket = n;
+    labelCount.assign(n + 1, 0);
+    for (auto &roots : buckets) roots.clear();
+
+    vector<FlowId> stack;
+    for (FlowId r = 0; r < n; r++) {
+        if (r == net.getSource() || r == net.getSink() || parent[r] != NO_ID) continue;
+        bool strong = excess[r] > FlowCore<Cap>::epsilon();
+        stack.push_back(r);
+        while (!stack.empty()) {
+            FlowId v = stack.back();
+            stack.pop_back();
+            labels[v] = strong ? 1 : 0;
+            labelCount[labels[v]]++;
+            currentArc[v] = net.firstArc(v);
+            for (FlowId c = firstChild[v]; c != NO_ID; c = nextSibling[c]) stack.push_back(c);
+        }
+        if (strong) addStrongRoot(r);
+    }
+}
+
+template <class Cap>
+FlowId Pseudoflow<Cap>::findMergerArc(FlowId v) {
+    FlowId a = currentArc[v];
+    while (a != NO_ID) {
+        FlowId w = net.getHead(a);
+        if (labels[w] + 1 == labels[v] && w != net.getSource() && w != net.getSink() && net.getResidual(a) > FlowCore<Cap>::epsilon()) break;
+        a = net.nextArc(a);
+    }
+    currentArc[v] = a;
+    return a;
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::checkChildren(FlowId v) {
+    for (; nextScan[v] != NO_ID; nextScan[v] = nextSibling[nextScan[v]]) {
+        if (labels[nextScan[v]] == labels[v]) return;
+    }
+    labelCount[labels[v]]--;
+    labels[v]++;
+    labelCount[labels[v]]++;
+    relabels++;
+    currentArc[v] = net.firstArc(v);
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::processRoot(FlowId r) {
+    // depth first over the vertices of the tree with the root's label; each is relabeled once its children are
+    FlowId v = r;
+    nextScan[v] = firstChild[v];
+    FlowId a = findMergerArc(v);
+    if (a != NO_ID) {
+        merge(r, v, a);
+        return;
+    }
+    checkChildren(v);
+    while (true) {
+        while (nextScan[v] != NO_ID) {
+            FlowId c = nextScan[v];
+            nextScan[v] = nextSibling[c];
+            v = c;
+            nextScan[v] = firstChild[v];
+            a = findMergerArc(v);
+            if (a != NO_ID) {
+                merge(r, v, a);
+                return;
+            }
+            checkChildren(v);
+        }
+        if (v == r) break;
+        v = parent[v];
+        checkChildren(v);
+    }
+    addStrongRoot(r);
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::merge(FlowId r, FlowId v, FlowId a) {
+    mergers++;
+
+    // reverse the path v ... r, so that r hangs below v, and v below the head of a
+    FlowId newParent = net.getHead(a);
+    FlowId newArc = a;
+    for (FlowId x = v; x != NO_ID;) {
+        FlowId oldParent = parent[x];
+        FlowId oldArc = parentArc[x];
+        if (oldParent != NO_ID) cut(x);
+        link(x, newParent, newArc);
+        newParent = x;
+        newArc = oldArc ^ 1;
+        x = oldParent;
+    }
+
+    Cap amount = excess[r];
+    excess[r] = 0;
+    pushExcess(r, amount);
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::pushExcess(FlowId v, Cap amount) {
+    while (parent[v] != NO_ID && amount > FlowCore<Cap>::epsilon()) {
+        FlowId a = parentArc[v];
+        FlowId p = parent[v];
+        Cap residual = net.getResidual(a);
+        if (residual >= amount) {
+            net.setFlow(a, net.getFlow(a) + amount);
+        }
+        else {
+            // split: v keeps what does not fit, as the root of a strong tree
+            net.setFlow(a, net.getCapacity(a));
+            cut(v);
+            excess[v] = amount - residual;
+            addStrongRoot(v);
+            amount = residual;
+        }
+        v = p;
+    }
+    if (parent[v] != NO_ID) return;
+    bool strong = excess[v] > FlowCore<Cap>::epsilon();
+    excess[v] += amount;
+    if (!strong && excess[v] > FlowCore<Cap>::epsilon()) addStrongRoot(v);
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::cancelCycles() {
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    auto carries = [&](FlowId a) {
+        FlowId w = net.getHead(a);
+        return w != source && w != sink && net.getFlow(a) > FlowCore<Cap>::epsilon();
+    };
+
+    enum : uint8_t { NEW, ON_STACK, DONE };
+    vector<uint8_t> state(n, NEW);
+    vector<FlowId> stack;
+    vector<FlowId> stackArc(n, NO_ID);    // arc from each vertex on the stack to the next one
+    for (FlowId v = 0; v < n; v++) currentArc[v] = net.firstArc(v);
+
+    for (FlowId u = 0; u < n; u++) {
+        if (u == source || u == sink || state[u] != NEW) continue;
+        stack.push_back(u);
+        state[u] = ON_STACK;
+        while (!stack.empty()) {
+            FlowId v = stack.back();
+            FlowId a = currentArc[v];
+            while (a != NO_ID && (!carries(a) || state[net.getHead(a)] == DONE)) a = net.nextArc(a);
+            currentArc[v] = a;
+            if (a == NO_ID) {
+                state[v] = DONE;
+                stack.pop_back();
+                continue;
+            }
+            FlowId w = net.getHead(a);
+            stackArc[v] = a;
+            if (state[w] == NEW) {
+                stack.push_back(w);
+                state[w] = ON_STACK;
+                continue;
+            }
+
+            // cycle w ... v -> w: cancel its smallest flow, then go back to the first arc it emptied
+            size_t start = stack.size() - 1;
+            while (stack[start] != w) start--;
+            Cap least = net.getFlow(a);
+            for (size_t i = start; i < stack.size(); i++) least = min(least, net.getFlow(stackArc[stack[i]]));
+            size_t emptied = stack.size();
+            for (size_t i = start; i < stack.size(); i++) {
+                FlowId b = stackArc[stack[i]];
+                net.setFlow(b, net.getFlow(b) - least);
+                if (emptied == stack.size() && net.getFlow(b) <= FlowCore<Cap>::epsilon()) emptied = i;
+            }
+            while (stack.size() > emptied + 1) {
+                state[stack.back()] = NEW;
+                currentArc[stack.back()] = net.firstArc(stack.back());
+                stack.pop_back();
+            }
+        }
+    }
+}
+
+template <class Cap>
+void Pseudoflow<Cap>::recoverFlow() {
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    cancelCycles();
+
+    // topological order of the arcs with flow, which are now acyclic
+    vector<FlowId> pending(n, 0);
+    for (FlowId v = 0; v < n; v++) {
+        if (v == source || v == sink) continue;
+        for (FlowId a = net.firstArc(v); a != NO_ID; a = net.nextArc(a)) {
+            FlowId w = net.getHead(a);
+            if (w != source && w != sink && net.getFlow(a) > FlowCore<Cap>::epsilon()) pending[w]++;
+        }
+    }
+    vector<FlowId> order;
+    for (FlowId v = 0; v < n; v++) {
+        if (v != source && v != sink && pending[v] == 0) order.push_back(v);
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        for (FlowId a = net.firstArc(order[i]); a != NO_ID; a = net.nextArc(a)) {
+            FlowId w = net.getHead(a);
+            if (w != source && w != sink && net.getFlow(a) > FlowCore<Cap>::epsilon() && --pending[w] == 0) order.push_back(w);
+        }
+    }
+
+    // excess goes back against the flow, downstream vertices first
+    for (auto it = order.rbegin(); it != order.rend(); it++) {
+        FlowId v = *it;
+        for (FlowId a = net.firstArc(v); a != NO_ID && excess[v] > FlowCore<Cap>::epsilon(); a = net.nextArc(a)) {
+            Cap in = -net.getFlow(a);    // flow of the twin, from the head of a into v
+            if (in <= FlowCore<Cap>::epsilon()) continue;
+            Cap f = min(excess[v], in);
+            net.setFlow(a, net.getFlow(a) + f);
+            excess[v] -= f;
+            excess[net.getHead(a)] += f;
+        }
+    }
+
+    // deficits stop the flow going out, upstream vertices first
+    for (FlowId v : order) {
+        for (FlowId a = net.firstArc(v); a != NO_ID && excess[v] < -FlowCore<Cap>::epsilon(); a = net.nextArc(a)) {
+            Cap out = net.getFlow(a);
+            if (out <= FlowCore<Cap>::epsilon()) continue;
+            Cap f = min(-excess[v], out);
+            net.setFlow(a, out - f);
+            excess[v] += f;
+            excess[net.getHead(a)] -= f;
+        }
+    }
+}
+
+template <class Cap>
+Cap Pseudoflow<Cap>::solve() {
+    initialize();
+    for (FlowId r = nextStrongRoot(); r != NO_ID; r = nextStrongRoot()) {
+        processRoot(r);
+    }
+    if (variant == HIGHEST_LABEL) {
+        // the gaps of the highest label order can leave strong trees that still reach weak ones
+        restartLowest();
+        for (FlowId r = nextStrongRoot(); r != NO_ID; r = nextStrongRoot()) {
+            processRoot(r);
+        }
+    }
+    recoverFlow();
+    return net.getFlowValue();
+}
+
+template class Pseudoflow<int32_t>;
+template class Pseudoflow<int64_t>;
+template class Pseudoflow<double>;
@@ -0,0 +1,211 @@
+#ifndef DA2324_PRJ1_G13_4_PSEUDOFLOW_H
+#define DA2324_PRJ1_G13_4_PSEUDOFLOW_H
+
+#include "FlowCore.h"
+
+/**
+ * @brief Order in which Pseudoflow processes the strong roots
+ */
+enum PseudoflowVariant { LOWEST_LABEL, HIGHEST_LABEL };
+
+/**
+ * @brief Hochbaum's pseudoflow algorithm (HPF).
+ *
+ * Every arc leaving the source and entering the sink is saturated, so each vertex starts with an excess (more water
+ * from the reservoirs than it can pass on) or a deficit. Vertices are kept in a forest of normalized trees, whose
+ * roots hold all the excess: strong trees (root excess > 0) and weak ones. Phase 1 repeatedly takes a strong root (of
+ * lowest or highest label) and looks in its tree for an arc v -> w with label(w) = label(v) - 1. If there is one, the
+ * tree is rerooted at v, hung from w, and its excess pushed up to the new root, splitting the tree wherever an arc is
+ * too small. Otherwise the vertices of the root's label are relabeled. A strong root is dropped when no vertex has the
+ * label just below its own (gap). When no strong root is left, the strong vertices are the source side of a minimum
+ * cut. With the highest label order, gaps can drop trees too early, so a lowest label pass from the resulting trees
+ * (cheap when there is nothing left to merge) finishes phase 1. Phase 2 turns the pseudoflow into a flow by cancelling flow cycles
+ * and sending the excesses back to the source and the deficits back to the sink, in topological order.
+ *
+ * Starts from the current flow of the network, apart from the arcs of the source and the sink.
+ */
+template <class Cap>
+class Pseudoflow {
+public:
+    /**
+     * @brief Prepares a solver
+     *
+     * Complexity: O(1)
+     *
+     * @param net : Network to solve
+     * @param variant : Which strong root is processed first
+     */
+    Pseudoflow(FlowCore<Cap> &net, PseudoflowVariant variant);
+
+    /**
+     * @brief Solves the max flow of the network
+     *
+     * Complexity: O(V^2 E)
+     *
+     * @return Max flow
+     */
+    Cap solve();
+
+    /**
+     * @brief Get number of mergers of the last solve
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of mergers
+     */
+    int getMergers() const;
+
+    /**
+     * @brief Get number of relabels of the last solve
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of relabels
+     */
+    int getRelabels() const;
+
+private:
+    FlowCore<Cap> &net;
+    PseudoflowVariant variant;
+    PseudoflowVariant order;     // order of the current pass
+    FlowId n = 0;
+    int mergers = 0;
+    int relabels = 0;
+
+    vector<Cap> excess;          // only roots hold excess
+    vector<FlowId> labels;
+    vector<FlowId> labelCount;   // vertices with each label, terminals excluded
+    vector<FlowId> currentArc;   // next arc to try as a merger arc
+
+    // trees
+    vector<FlowId> parent;
+    vector<FlowId> parentArc;    // arc from each vertex to its parent, the way its excess goes up
+    vector<FlowId> firstChild;
+    vector<FlowId> nextSibling;
+    vector<FlowId> prevSibling;
+    vector<FlowId> nextScan;     // next child to visit by the search of processRoot
+
+    // strong roots by label, entries that are no longer strong roots with that label are skipped
+    vector<vector<FlowId>> buckets;
+    FlowId bucket = 0;           // lowest / highest label that may have a strong root
+
+    /**
+     * @brief Saturates the arcs of the terminals and makes every other vertex a tree of its own
+     *
+     * Complexity: O(V + E)
+     */
+    void initialize();
+
+    /**
+     * @brief Starts a lowest label pass from the current trees: label 1 for the vertices of strong trees, 0 for the
+     * others
+     *
+     * Complexity: O(V)
+     */
+    void restartLowest();
+
+    /**
+     * @brief Records a strong root so that it is processed
+     *
+     * Complexity: O(1) amortized
+     *
+     * @param r : Root
+     */
+    void addStrongRoot(FlowId r);
+
+    /**
+     * @brief Takes the next strong root to process
+     *
+     * Complexity: O(1) amortized
+     *
+     * @return Root, or NO_ID when there are no strong roots below label V
+     */
+    FlowId nextStrongRoot();
+
+    /**
+     * @brief Looks for a merger arc in the tree of a strong root, among the vertices with the root's label, and merges
+     * or relabels them
+     *
+     * Complexity: O(size of the tree + arcs scanned)
+     *
+     * @param r : Strong root
+     */
+    void processRoot(FlowId r);
+
+    /**
+     * @brief Get the next arc of a vertex to a vertex one label lower, with residual capacity
+     *
+     * Complexity: O(arcs scanned)
+     *
+     * @param v : Vertex
+     * @return Arc, or NO_ID
+     */
+    FlowId findMergerArc(FlowId v);
+
+    /**
+     * @brief Moves the scan of a vertex to its next child with the same label, relabeling the vertex if there is none
+     *
+     * Complexity: O(children scanned)
+     *
+     * @param v : Vertex
+     */
+    void checkChildren(FlowId v);
+
+    /**
+     * @brief Reroots the tree of r at v, hangs it from the head of a merger arc and pushes the excess of r to the root
+     *
+     * Complexity: O(depth of the new tree)
+     *
+     * @param r : Strong root
+     * @param v : Vertex of its tree
+     * @param a : Merger arc leaving v
+     */
+    void merge(FlowId r, FlowId v, FlowId a);
+
+    /**
+     * @brief Pushes excess from a vertex up to the root of its tree, splitting the tree at the arcs that are too small
+     *
+     * Complexity: O(depth)
+     *
+     * @param v : Vertex
+     * @param amount : Excess
+     */
+    void pushExcess(FlowId v, Cap amount);
+
+    /**
+     * @brief Links a vertex to a parent
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Root of a tree
+     * @param p : New parent
+     * @param a : Arc v -> p
+     */
+    void link(FlowId v, FlowId p, FlowId a);
+
+    /**
+     * @brief Detaches a vertex from its parent, making it a root
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex with a parent
+     */
+    void cut(FlowId v);
+
+    /**
+     * @brief Phase 2: removes the flow cycles, then sends the excesses back to the source and the deficits back to the
+     * sink
+     *
+     * Complexity: O(V E) worst case, O(V + E) with no flow cycles
+     */
+    void recoverFlow();
+
+    /**
+     * @brief Removes the cycles of the arcs with flow, among the vertices other than the terminals
+     *
+     * Complexity: O(V E)
+     */
+    void cancelCycles();
+};
+
+#endif //DA2324_PRJ1_G13_4_PSEUDOFLOW_H
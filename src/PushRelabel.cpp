@@ -0,0 +1,170 @@
+#include "PushRelabel.h"
+#include "WorkerPool.h"
+#include <algorithm>
+
+template <class Cap>
+static void atomicAdd(atomic<Cap> &target, Cap value) {
+    Cap current = target.load(memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, memory_order_relaxed)) {}
+}
+
+template <class Cap>
+PushRelabel<Cap>::PushRelabel(FlowCore<Cap> &net, unsigned threads): net(net), threads(threads), touchedCount(0), relabels(0) {}
+
+template <class Cap>
+int PushRelabel<Cap>::getRounds() const {
+    return rounds;
+}
+
+template <class Cap>
+int PushRelabel<Cap>::getGlobalRelabels() const {
+    return globalRelabels;
+}
+
+template <class Cap>
+void PushRelabel<Cap>::touch(FlowId v) {
+    if (!queued[v].exchange(true, memory_order_relaxed)) touched[touchedCount++] = v;
+}
+
+template <class Cap>
+void PushRelabel<Cap>::discharge(FlowId v) {
+    Cap e = excess[v];
+    FlowId d = labels[v].load(memory_order_relaxed);
+    FlowId a = currentArc[v];
+    for (; a != NO_ID; a = net.nextArc(a)) {
+        FlowId w = net.getHead(a);
+        if (labels[w].load(memory_order_relaxed) + 1 != d) continue;    // the label first: w may be pushing on a ^ 1
+        Cap r = net.getResidual(a);
+        if (r <= FlowCore<Cap>::epsilon()) continue;
+        Cap f = min(e, r);
+        net.setFlow(a, net.getFlow(a) + f);
+        e -= f;
+        atomicAdd(incoming[w], f);
+        if (w != net.getSource() && w != net.getSink()) touch(w);
+        if (e <= FlowCore<Cap>::epsilon()) break;    // a may still have room
+    }
+    currentArc[v] = a;
+    excess[v] = e;
+    if (e > FlowCore<Cap>::epsilon()) touch(v);
+}
+
+template <class Cap>
+void PushRelabel<Cap>::relabel(FlowId v) {
+    queued[v].store(false, memory_order_relaxed);
+    excess[v] += incoming[v].exchange(0, memory_order_relaxed);
+    FlowId d = labels[v].load(memory_order_relaxed);
+    newLabels[v] = d;
+    if (excess[v] <= FlowCore<Cap>::epsilon() || currentArc[v] != NO_ID) return;
+
+    // every arc was tried, so none is admissible: one above the lowest residual neighbour
+    FlowId lowest = 2 * n;
+    for (FlowId a = net.firstArc(v); a != NO_ID; a = net.nextArc(a)) {
+        if (net.getResidual(a) > FlowCore<Cap>::epsilon()) lowest = min(lowest, labels[net.getHead(a)].load(memory_order_relaxed) + 1);
+    }
+    newLabels[v] = max(d + 1, lowest);
+    relabels++;
+}
+
+template <class Cap>
+void PushRelabel<Cap>::labelFrom(FlowId from, FlowId blocked, WorkerPool &pool) {
+    vector<FlowId> frontier = {from};
+    vector<FlowId> following(n);
+    atomic<size_t> followingCount(0);
+    while (!frontier.empty()) {
+        followingCount = 0;
+        pool.run(frontier.size(), [&](size_t i) {
+            FlowId v = frontier[i];
+            FlowId level = labels[v].load(memory_order_relaxed) + 1;
+            // u reaches v through the twin of each arc v -> u
+            for (FlowId a = net.firstArc(v); a != NO_ID; a = net.nextArc(a)) {
+                FlowId u = net.getHead(a);
+                if (u == blocked || net.getResidual(a ^ 1) <= FlowCore<Cap>::epsilon()) continue;
+                FlowId unset = 2 * n;
+                if (labels[u].compare_exchange_strong(unset, level, memory_order_relaxed)) following[followingCount++] = u;
+            }
+        });
+        frontier.assign(following.begin(), following.begin() + (ptrdiff_t) followingCount.load());
+    }
+}
+
+template <class Cap>
+void PushRelabel<Cap>::globalRelabel(WorkerPool &pool) {
+    globalRelabels++;
+    relabels = 0;
+    pool.run(n, [&](size_t v) {
+        labels[v].store(2 * n, memory_order_relaxed);
+        currentArc[v] = net.firstArc((FlowId) v);
+    });
+    labels[net.getSink()] = 0;
+    labelFrom(net.getSink(), net.getSource(), pool);
+    labels[net.getSource()] = n;
+    labelFrom(net.getSource(), net.getSink(), pool);
+}
+
+template <class Cap>
+Cap PushRelabel<Cap>::solve() {
+    FlowId source = net.getSource();
+    FlowId sink = net.getSink();
+    n = net.numVertices();
+    rounds = 0;
+    globalRelabels = 0;
+    labels.reset(new atomic<FlowId>[n]);
+    incoming.reset(new atomic<Cap>[n]);
+    queued.reset(new atomic<bool>[n]);
+    newLabels.assign(n, 0);
+    excess.assign(n, 0);
+    currentArc.assign(n, NO_ID);
+    active.clear();
+    touched.assign(n, NO_ID);
+
+    WorkerPool pool(threads);
+    pool.run(n, [&](size_t v) {
+        incoming[v].store(0, memory_order_relaxed);
+        queued[v].store(false, memory_order_relaxed);
+        for (FlowId a = net.firstArc((FlowId) v); a != NO_ID; a = net.nextArc(a)) {
+            excess[v] -= net.getFlow(a);    // the twin of each arc into v carries minus its flow
+        }
+    });
+
+    // saturate every residual arc leaving the source
+    for (FlowId a = net.firstArc(source); a != NO_ID; a = net.nextArc(a)) {
+        Cap r = net.getResidual(a);
+        if (r <= FlowCore<Cap>::epsilon()) continue;
+        net.setFlow(a, net.getCapacity(a));
+        excess[net.getHead(a)] += r;
+        excess[source] -= r;
+    }
+    globalRelabel(pool);
+
+    auto isActive = [&](FlowId v) {
+        return v != source && v != sink && excess[v] > FlowCore<Cap>::epsilon() && labels[v].load(memory_order_relaxed) < 2 * n;
+    };
+    for (FlowId v = 0; v < n; v++) {
+        if (isActive(v)) active.push_back(v);
+    }
+
+    while (!active.empty()) {
+        rounds++;
+        touchedCount = 0;
+        pool.run(active.size(), [&](size_t i) { discharge(active[i]); });
+        size_t count = touchedCount;
+        pool.run(count, [&](size_t i) { relabel(touched[i]); });
+        pool.run(count, [&](size_t i) {
+            FlowId v = touched[i];
+            if (newLabels[v] == labels[v].load(memory_order_relaxed)) return;
+            labels[v].store(min(newLabels[v], 2 * n), memory_order_relaxed);
+            currentArc[v] = net.firstArc(v);
+        });
+        if (relabels >= n) globalRelabel(pool);
+
+        active.clear();
+        for (size_t i = 0; i < count; i++) {
+            if (isActive(touched[i])) active.push_back(touched[i]);
+        }
+    }
+    return net.getFlowValue();
+}
+
+template class PushRelabel<int32_t>;
+template class PushRelabel<int64_t>;
+template class PushRelabel<double>;
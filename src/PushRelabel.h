@@ -0,0 +1,132 @@
+#ifndef DA2324_PRJ1_G13_4_PUSHRELABEL_H
+#define DA2324_PRJ1_G13_4_PUSHRELABEL_H
+
+#include <atomic>
+#include <memory>
+#include "FlowCore.h"
+
+class WorkerPool;
+
+/**
+ * @brief Shared-memory parallel push-relabel, to spread one max flow solve over every core.
+ *
+ * Works in synchronous rounds. In each round all active vertices (excess > 0) are discharged at the same time against
+ * the labels of the start of the round: v only pushes on arcs v -> w with label(v) = label(w) + 1, so no two threads
+ * ever push on the same arc or its twin, and the excess a vertex receives is added atomically. Vertices still holding
+ * excess are then relabeled, again in parallel and against the old labels, which keeps the labeling valid. Global
+ * relabels (level-synchronous parallel BFS from the sink, then from the source for the water that has to go back)
+ * run whenever about V relabels were done since the last one.
+ *
+ * Starts from the current flow of the network. The max flow value is the same as Edmonds Karp's; when there are
+ * several max flows, the one found may split the water differently.
+ */
+template <class Cap>
+class PushRelabel {
+public:
+    /**
+     * @brief Prepares a solver
+     *
+     * Complexity: O(1)
+     *
+     * @param net : Network to solve
+     * @param threads : Number of threads (0 for one per hardware thread)
+     */
+    explicit PushRelabel(FlowCore<Cap> &net, unsigned threads = 0);
+
+    /**
+     * @brief Solves the max flow of the network, starting from its current flow
+     *
+     * Complexity: O(V^2 E) work in the worst case (O(V^3) rounds bound), spread over the threads
+     *
+     * @return Max flow
+     */
+    Cap solve();
+
+    /**
+     * @brief Get number of rounds of the last solve
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of rounds
+     */
+    int getRounds() const;
+
+    /**
+     * @brief Get number of global relabels of the last solve
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of global relabels
+     */
+    int getGlobalRelabels() const;
+
+private:
+    FlowCore<Cap> &net;
+    unsigned threads;
+    FlowId n = 0;
+
+    unique_ptr<atomic<FlowId>[]> labels;     // read by the neighbours while a vertex is discharged
+    unique_ptr<atomic<Cap>[]> incoming;      // excess received in the current round
+    unique_ptr<atomic<bool>[]> queued;       // whether a vertex is already in touched
+    vector<FlowId> newLabels;
+    vector<Cap> excess;
+    vector<FlowId> currentArc;
+
+    vector<FlowId> active;          // vertices discharged in the next round
+    vector<FlowId> touched;         // vertices that kept or received excess in this round
+    atomic<size_t> touchedCount;
+    atomic<size_t> relabels;
+
+    int rounds = 0;
+    int globalRelabels = 0;
+
+    /**
+     * @brief Pushes the excess of a vertex along its admissible arcs
+     *
+     * Complexity: O(deg(v))
+     *
+     * @param v : Active vertex
+     */
+    void discharge(FlowId v);
+
+    /**
+     * @brief Adds the excess received by a vertex and computes its new label (in newLabels) if it has no admissible arc
+     *
+     * Complexity: O(deg(v))
+     *
+     * @param v : Touched vertex
+     */
+    void relabel(FlowId v);
+
+    /**
+     * @brief Adds a vertex to touched, once per round
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Vertex
+     */
+    void touch(FlowId v);
+
+    /**
+     * @brief Sets every label to the residual distance to the sink, or to V + the residual distance to the source for
+     * the vertices that can not reach the sink
+     *
+     * Complexity: O(V + E) work, O(diameter) parallel steps
+     *
+     * @param pool : Threads
+     */
+    void globalRelabel(WorkerPool &pool);
+
+    /**
+     * @brief Level-synchronous parallel BFS over the residual arcs entering the frontier, labeling unlabeled vertices
+     *
+     * Complexity: O(V + E) work
+     *
+     * @param from : Start vertex (already labeled)
+     * @param blocked : Vertex that is not labeled (the other terminal)
+     * @param pool : Threads
+     */
+    void labelFrom(FlowId from, FlowId blocked, WorkerPool &pool);
+};
+
+#endif //DA2324_PRJ1_G13_4_PUSHRELABEL_H
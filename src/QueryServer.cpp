@@ -0,0 +1,339 @@
+#include "QueryServer.h"
+#include "csvInfo.h"
+#include "ResultCache.h"
+#include "NetworkEditor.h"
+#include "NetworkStats.h"
+#include "ResultWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+std::shared_timed_mutex QueryServer::networkLock;
+atomic<bool> QueryServer::stopping(false);
+int QueryServer::listenFd = -1;
+bool QueryServer::balanced = false;
+vector<double> QueryServer::balanceInitial;
+vector<double> QueryServer::balanceFinal;
+
+static string jsonString(const string &s) {
+    string res;
+    JsonLinesWriter::appendString(res, s);
+    return res;
+}
+
+static string jsonNumber(double d) {
+    if (d == 0) d = 0;    // no "-0"
+    char text[32];
+    snprintf(text, sizeof(text), "%.15g", d);
+    return text;
+}
+
+/**
+ * Checks that a value is a JSON number as written by the grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+static bool isJsonNumber(const string &s) {
+    size_t i = 0;
+    auto digits = [&]() {
+        size_t start = i;
+        while (i < s.size() && isdigit((unsigned char) s[i])) i++;
+        return i > start;
+    };
+    if (i < s.size() && s[i] == '-') i++;
+    if (i < s.size() && s[i] == '0') i++;
+    else if (!digits()) return false;
+    if (i < s.size() && s[i] == '.') {
+        i++;
+        if (!digits()) return false;
+    }
+    if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+        i++;
+        if (i < s.size() && (s[i] == '+' || s[i] == '-')) i++;
+        if (!digits()) return false;
+    }
+    return i == s.size();
+}
+
+/**
+ * Parses a flat JSON object. Values are kept unescaped (strings) or as written (numbers, true, false, null), and the
+ * raw text of each value in tokens, to echo it back.
+ */
+static bool parseObject(const string &s, map<string, string> &values, map<string, string> &tokens, string &error) {
+    size_t i = 0;
+    auto skip = [&]() { while (i < s.size() && isspace((unsigned char) s[i])) i++; };
+    auto parseString = [&](string &out) {
+        out.clear();
+        i++;    // opening quote
+        while (i < s.size() && s[i] != '"') {
+            if (s[i] == '\\' && i + 1 < s.size()) {
+                i++;
+                switch (s[i]) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                        if (i + 4 >= s.size()) return false;
+                        out += (char) strtol(s.substr(i + 1, 4).c_str(), nullptr, 16);    // codes of this project are ASCII
+                        i += 4;
+                        break;
+                    default: out += s[i];
+                }
+            }
+            else out += s[i];
+            i++;
+        }
+        if (i == s.size()) return false;
+        i++;    // closing quote
+        return true;
+    };
+
+    skip();
+    if (i == s.size() || s[i] != '{') {
+        error = "request is not a JSON object";
+        return false;
+    }
+    i++;
+    skip();
+    if (i < s.size() && s[i] == '}') return true;
+    while (true) {
+        skip();
+        string key;
+        if (i == s.size() || s[i] != '"' || !parseString(key)) {
+            error = "expected a field name";
+            return false;
+        }
+        skip();
+        if (i == s.size() || s[i] != ':') {
+            error = "expected ':' after \"" + key + "\"";
+            return false;
+        }
+        i++;
+        skip();
+        size_t start = i;
+        string value;
+        if (i < s.size() && s[i] == '"') {
+            if (!parseString(value)) {
+                error = "unterminated string";
+                return false;
+            }
+        }
+        else {
+            while (i < s.size() && s[i] != ',' && s[i] != '}' && !isspace((unsigned char) s[i])) i++;
+            value = s.substr(start, i - start);
+            if (value.empty() || value[0] == '{' || value[0] == '[') {
+                error = "unsupported value of \"" + key + "\"";
+                return false;
+            }
+        }
+        tokens[key] = s.substr(start, i - start);
+        values[key] = value;
+        skip();
+        if (i < s.size() && s[i] == ',') {
+            i++;
+            continue;
+        }
+        if (i < s.size() && s[i] == '}') return true;
+        error = "expected ',' or '}'";
+        return false;
+    }
+}
+
+FlowNetwork &QueryServer::network() {
+    static FlowNetwork live(*ResultCache::solvedNetwork());
+    return live;
+}
+
+string QueryServer::flowReply(const FlowNetwork &net, double maxFlow, const vector<double> &cityFlows, double baselineFlow) {
+    string reply = "\"maxFlow\":" + jsonNumber(maxFlow) + ",\"lost\":" + jsonNumber(baselineFlow - maxFlow) + ",\"cities\":[";
+    for (int i = 0; i < (int) cityFlows.size(); i++) {
+        City c = csvInfo::citiesVector[i];
+        double demand = net.getCapacity(net.getCityArc(i));    // edits may have changed it
+        if (i > 0) reply += ',';
+        reply += "{\"code\":" + jsonString(c.getCode()) + ",\"name\":" + jsonString(c.getCity()) + ",\"demand\":"
+                 + jsonNumber(demand) + ",\"water\":" + jsonNumber(cityFlows[i]) + ",\"deficit\":"
+                 + jsonNumber(cityFlows[i] < demand ? demand - cityFlows[i] : 0) + "}";
+    }
+    return reply + "]";
+}
+
+bool QueryServer::scenarioReply(const string &text, string &reply) {
+    const FlowNetwork &baseline = network();
+    Scenario s;
+    string error;
+    if (!ScenarioEngine::parseScenario(text, baseline, s, error)) {
+        reply = error;
+        return false;
+    }
+    vector<ScenarioResult> results = ScenarioEngine::evaluateAll(baseline, {s}, 1);
+    reply = flowReply(baseline, results[0].maxFlow, results[0].cityFlows, baseline.getFlowValue());
+    return true;
+}
+
+string QueryServer::answer(const string &request) {
+    map<string, string> values;
+    map<string, string> tokens;
+    string error;
+    string reply;
+    bool ok = parseObject(request, values, tokens, error);
+    string id = "null";
+    if (tokens.count("id")) {
+        const string &token = tokens["id"];
+        if (!token.empty() && token[0] == '"') id = jsonString(values["id"]);    // escaped again, so it is valid JSON
+        else if (token == "null" || isJsonNumber(token)) id = token;
+        else if (ok) {
+            ok = false;
+            error = "\"id\" must be a string, a number or null";
+        }
+    }
+    string query = values["query"];
+    string target = values["target"];
+
+    if (!ok) {}
+    else if (query == "ping") {}
+    else if (query == "remove" && (target.empty() || target.find_first_of(";: \t\r\n") != string::npos)) {
+        ok = false;
+        error = "the target must be a single code or pipe (\"A->B\")";
+    }
+    else if (query == "maxFlow") {
+        std::shared_lock<std::shared_timed_mutex> guard(networkLock);
+        const FlowNetwork &baseline = network();
+        reply = flowReply(baseline, baseline.getFlowValue(), baseline.getCityFlows(), baseline.getFlowValue());
+    }
+    else if (query == "remove" || query == "scenario") {
+        string text = query == "remove" ? "remove " + target + ": close " + target
+                                        : "scenario: " + values["actions"];
+        std::shared_lock<std::shared_timed_mutex> guard(networkLock);
+        ok = scenarioReply(text, reply);
+        if (!ok) error = reply;
+    }
+    else if (query == "edit") {
+        std::unique_lock<std::shared_timed_mutex> guard(networkLock);
+        ok = NetworkEditor::apply(network(), values["edit"], error);
+        if (ok) {
+            reply = "\"maxFlow\":" + jsonNumber(network().getFlowValue());
+            balanced = false;
+        }
+    }
+    else if (query == "balance") {
+        std::unique_lock<std::shared_timed_mutex> guard(networkLock);
+        if (!balanced) {
+            FlowNetwork balancedNetwork(network());
+            balancedNetwork.balanceFlows();
+            balanceInitial = NetworkStats::fromFlowNetwork(network()).getMetrics();
+            balanceFinal = NetworkStats::fromFlowNetwork(balancedNetwork).getMetrics();
+            balanced = true;
+        }
+        string names[7] = {"maxFlow", "average", "variance", "maxDiff", "median", "p90", "p99"};
+        string initial, final;
+        for (int i = 0; i < 7; i++) {
+            initial += (i > 0 ? "," : "") + jsonString(names[i]) + ":" + jsonNumber(balanceInitial[i]);
+            final += (i > 0 ? "," : "") + jsonString(names[i]) + ":" + jsonNumber(balanceFinal[i]);
+        }
+        reply = "\"initial\":{" + initial + "},\"final\":{" + final + "}";
+    }
+    else if (query == "shutdown") {
+        stopping = true;
+#ifndef _WIN32
+        if (listenFd >= 0) shutdown(listenFd, SHUT_RDWR);
+#endif
+    }
+    else {
+        ok = false;
+        error = "unknown query '" + query + "'";
+    }
+
+    if (!ok) return "{\"id\":" + id + ",\"ok\":false,\"error\":" + jsonString(error) + "}";
+    return "{\"id\":" + id + ",\"ok\":true" + (reply.empty() ? "" : "," + reply) + "}";
+}
+
+#ifndef _WIN32
+
+void QueryServer::handleConnection(int fd) {
+    string pending;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        pending.append(buffer, (size_t) n);
+        size_t end;
+        while ((end = pending.find('\n')) != string::npos) {
+            string line = pending.substr(0, end);
+            pending.erase(0, end + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == string::npos) continue;
+
+            string reply = answer(line) + "\n";
+            size_t sent = 0;
+            while (sent < reply.size()) {
+#ifdef MSG_NOSIGNAL
+                ssize_t k = send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+#else
+                ssize_t k = send(fd, reply.data() + sent, reply.size() - sent, 0);
+#endif
+                if (k <= 0) {
+                    close(fd);
+                    return;
+                }
+                sent += (size_t) k;
+            }
+        }
+    }
+    close(fd);
+}
+
+int QueryServer::serve(const string &socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: socket path too long." << endl;
+        return 1;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        cerr << "Error: Unable to create the socket." << endl;
+        return 1;
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (sockaddr *) &address, sizeof(address)) < 0 || listen(listenFd, 64) < 0) {
+        cerr << "Error: Unable to listen on " << socketPath << "." << endl;
+        close(listenFd);
+        return 1;
+    }
+
+    network();    // solve the baseline before the first request
+    cout << "Listening on " << socketPath << endl;
+    while (!stopping) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (stopping) break;
+            if (errno == EINTR) continue;
+            cerr << "Error: Unable to accept a connection." << endl;
+            break;
+        }
+        thread(handleConnection, fd).detach();
+    }
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath.c_str());
+    return 0;
+}
+
+#else
+
+void QueryServer::handleConnection(int fd) {}
+
+int QueryServer::serve(const string &socketPath) {
+    cerr << "Error: server mode needs Unix domain sockets." << endl;
+    return 1;
+}
+
+#endif
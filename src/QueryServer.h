@@ -0,0 +1,100 @@
+#ifndef DA2324_PRJ1_G13_4_QUERYSERVER_H
+#define DA2324_PRJ1_G13_4_QUERYSERVER_H
+
+#include <atomic>
+#include <shared_mutex>
+#include "ScenarioEngine.h"
+
+/**
+ * @brief Long-running server answering queries over a Unix domain socket, with the network loaded once and its max flow
+ * kept solved.
+ *
+ * The protocol is line-delimited JSON: every request is one flat object on a line and gets one object on a line back,
+ * with the same "id" (a string, a number or null). Requests ("query" field):
+ * - {"query":"maxFlow"}: max flow and water of each city.
+ * - {"query":"remove","target":"PS_40"}: the same with one reservoir, station, city or pipe ("A->B") out of service.
+ * - {"query":"scenario","actions":"close PS_40; scale R_1 50%"}: any scenario, in the syntax of scenario files.
+ * - {"query":"edit","edit":"set PS_30->C_7 150"}: a live edit (see NetworkEditor), answered with the new max flow.
+ * - {"query":"balance"}: metrics of the live network (edits included) before and after balancing its flow.
+ * - {"query":"ping"} and {"query":"shutdown"}.
+ * Failed requests get "ok":false and an "error". Every connection is served by its own thread; read queries run in
+ * parallel (shared lock) on the live network, while edits, and balance, which keeps its answer until the next edit, run
+ * alone.
+ */
+class QueryServer {
+public:
+    /**
+     * @brief Listens on a socket and answers requests until a shutdown request
+     *
+     * Complexity: O(1) per connection, plus the queries
+     *
+     * @param socketPath : Path of the socket (replaced if it exists)
+     * @return Exit status
+     */
+    static int serve(const string &socketPath);
+
+    /**
+     * @brief Answers one request
+     *
+     * Complexity: O(V + E) for maxFlow and usually for edits, O(V E^2) for removals and scenarios in the worst case, O(1)
+     * for balance until the next edit
+     *
+     * @param request : JSON request
+     * @return JSON answer, without line break
+     */
+    static string answer(const string &request);
+
+private:
+    static std::shared_timed_mutex networkLock;
+    static atomic<bool> stopping;
+    static int listenFd;
+
+    // answer of the balance query for the live network, cleared by every edit
+    static bool balanced;
+    static vector<double> balanceInitial;
+    static vector<double> balanceFinal;
+
+    /**
+     * @brief Get the live network: the solved network of the loaded data, with the edits received so far
+     *
+     * Complexity: O(V E^2) the first time, O(1) afterwards
+     *
+     * @return Solved network
+     */
+    static FlowNetwork &network();
+
+    /**
+     * @brief Answers the requests of a connection until it is closed
+     *
+     * Complexity: O(requests)
+     *
+     * @param fd : Connection socket
+     */
+    static void handleConnection(int fd);
+
+    /**
+     * @brief Evaluates a scenario against the live network
+     *
+     * Complexity: O(V E^2) in the worst case
+     *
+     * @param text : Scenario, "name: action; ..."
+     * @param reply : Fields of the answer, after the id (output)
+     * @return True if the scenario is valid
+     */
+    static bool scenarioReply(const string &text, string &reply);
+
+    /**
+     * @brief Get the fields of an answer with the max flow and the water of each city
+     *
+     * Complexity: O(C)
+     *
+     * @param net : Network the demands are taken from
+     * @param maxFlow : Max flow
+     * @param cityFlows : Water reaching each city
+     * @param baselineFlow : Max flow of the network without changes
+     * @return JSON fields
+     */
+    static string flowReply(const FlowNetwork &net, double maxFlow, const vector<double> &cityFlows, double baselineFlow);
+};
+
+#endif //DA2324_PRJ1_G13_4_QUERYSERVER_H
@@ -1,30 +1,70 @@
 #include "Reservoir.h"
-#include <utility>
 
-Reservoir::Reservoir(string r, string m, int i, string c, int md) {
-    reservoir = std::move(r);
-    municipality = std::move(m);
-    Id = i;
-    code = std::move(c);
-    maxDelivery = md;
+Reservoir::Reservoir(const ReservoirTable *t, size_t r) {
+    table = t;
+    row = r;
 }
 
-string Reservoir::getReservoir() {
-    return reservoir;
+const string &Reservoir::getReservoir() const {
+    return table->pool->get(table->names[row]);
 }
 
-string Reservoir::getMunicipality() {
-    return municipality;
+const string &Reservoir::getMunicipality() const {
+    return table->pool->get(table->municipalities[row]);
 }
 
 int Reservoir::getId() const {
-    return Id;
+    return table->ids[row];
 }
 
-string Reservoir::getCode() {
-    return code;
+const string &Reservoir::getCode() const {
+    return table->pool->get(table->codes[row]);
 }
 
 int Reservoir::getMaxDelivery() const {
-    return maxDelivery;
+    return table->maxDeliveries[row];
+}
+
+ReservoirTable::ReservoirTable(StringPool &p) {
+    pool = &p;
+}
+
+void ReservoirTable::add(const string &r, const string &m, int i, const string &c, int md) {
+    names.push_back(pool->intern(r));
+    municipalities.push_back(pool->intern(m));
+    ids.push_back(i);
+    codes.push_back(pool->intern(c));
+    maxDeliveries.push_back(md);
+}
+
+void ReservoirTable::clear() {
+    names.clear();
+    municipalities.clear();
+    ids.clear();
+    codes.clear();
+    maxDeliveries.clear();
+}
+
+size_t ReservoirTable::size() const {
+    return ids.size();
+}
+
+bool ReservoirTable::empty() const {
+    return ids.empty();
+}
+
+Reservoir ReservoirTable::operator[](size_t i) const {
+    return Reservoir(this, i);
+}
+
+ReservoirTable::iterator ReservoirTable::begin() const {
+    return iterator(this, 0);
+}
+
+ReservoirTable::iterator ReservoirTable::end() const {
+    return iterator(this, size());
+}
+
+const vector<int> &ReservoirTable::getMaxDeliveries() const {
+    return maxDeliveries;
 }
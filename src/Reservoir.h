@@ -2,29 +2,28 @@
 #define DA2324_PRJ1_G13_4_RESERVOIR_H
 
 #include <string>
+#include <vector>
+#include "EntityIterator.h"
+#include "StringPool.h"
 using namespace std;
 
+class ReservoirTable;
+
 /**
- * @brief Represents a Reservoir
+ * @brief Represents a Reservoir (a view of one row of a ReservoirTable, cheap to copy)
  */
 class Reservoir {
 private:
-    string reservoir;
-    string municipality;
-    int Id;
-    string code;
-    int maxDelivery;
+    const ReservoirTable *table;
+    size_t row;
 public:
     /**
-     * @brief Constructor of the Station class
+     * @brief Constructor of the Reservoir class
      *
-     * @param r : Reservoir's name
-     * @param m : Municipality
-     * @param i : Id
-     * @param c : Code
-     * @param md : Maximum delivery
+     * @param t : Table of the Reservoir
+     * @param r : Row of the Reservoir in the table
      */
-    Reservoir(string r, string m, int i, string c, int md);
+    Reservoir(const ReservoirTable *t, size_t r);
 
     /**
      * @brief Get the name of the Reservoir
@@ -33,7 +32,7 @@ public:
      *
      * @return Returns the value of the Reservoir's Name
      */
-    string getReservoir();
+    const string &getReservoir() const;
 
     /**
      * @brief Get the municipality of the Reservoir
@@ -42,7 +41,7 @@ public:
      *
      * @return Returns the value of the Reservoir's municipality
      */
-    string getMunicipality();
+    const string &getMunicipality() const;
 
     /**
      * @brief Get the Id of the Reservoir
@@ -60,7 +59,7 @@ public:
      *
      * @return Returns the value of the Reservoir's code
      */
-    string getCode();
+    const string &getCode() const;
 
     /**
      * @brief Get the max delivery of the Reservoir
@@ -72,5 +71,90 @@ public:
     int getMaxDelivery() const;
 };
 
+/**
+ * @brief All the reservoirs, one column per field, with names, municipalities and codes interned in a StringPool.
+ */
+class ReservoirTable {
+public:
+    typedef EntityIterator<ReservoirTable, Reservoir> iterator;
+
+    /**
+     * @brief Constructor of the ReservoirTable class
+     *
+     * @param p : Pool of the names, municipalities and codes (must outlive the table)
+     */
+    explicit ReservoirTable(StringPool &p);
+
+    /**
+     * @brief Adds a Reservoir at the end of the table
+     *
+     * Complexity: O(|r| + |m| + |c|) amortized
+     *
+     * @param r : Reservoir's name
+     * @param m : Municipality
+     * @param i : Id
+     * @param c : Code
+     * @param md : Maximum delivery
+     */
+    void add(const string &r, const string &m, int i, const string &c, int md);
+
+    /**
+     * @brief Removes every Reservoir (the interned strings stay in the pool)
+     *
+     * Complexity: O(1)
+     */
+    void clear();
+
+    /**
+     * @brief Get number of reservoirs
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of reservoirs
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check if there are no reservoirs
+     *
+     * Complexity: O(1)
+     *
+     * @return True or false
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get a Reservoir by its row
+     *
+     * Complexity: O(1)
+     *
+     * @param i : Row
+     * @return Reservoir
+     */
+    Reservoir operator[](size_t i) const;
+
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+     * @brief Get the max delivery of every Reservoir, by row
+     *
+     * Complexity: O(1)
+     *
+     * @return Max deliveries
+     */
+    const vector<int> &getMaxDeliveries() const;
+
+private:
+    friend class Reservoir;
+
+    StringPool *pool;
+    vector<StringId> names;
+    vector<StringId> municipalities;
+    vector<int> ids;
+    vector<StringId> codes;
+    vector<int> maxDeliveries;
+};
+
 
 #endif //DA2324_PRJ1_G13_4_RESERVOIR_H
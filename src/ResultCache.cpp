@@ -0,0 +1,137 @@
+#include "ResultCache.h"
+#include "csvInfo.h"
+#include "SolverTuner.h"
+#include <cstring>
+
+map<uint64_t, ResultCache::MaxFlowEntry> ResultCache::maxFlows;
+map<uint64_t, ScenarioResult> ResultCache::scenarios;
+uint64_t ResultCache::networkKey = 0;
+shared_ptr<const FlowNetwork> ResultCache::network;
+uint64_t ResultCache::decompositionKey = 0;
+shared_ptr<const FlowDecomposition> ResultCache::decomposition;
+std::mutex ResultCache::lock;
+
+static uint64_t hashDouble(double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static uint64_t hashString(const string &s) {
+    uint64_t h = 1469598103934665603ULL;    // FNV-1a
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t ResultCache::combine(uint64_t seed, uint64_t v) {
+    return seed ^ (v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+uint64_t ResultCache::hashPipesGraph() {
+    uint64_t h = 0;
+    for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
+        h = combine(h, hashString(v->getInfo()));
+        h = combine(h, v->getType());
+        for (Edge* e : v->getAdj()) {
+            h = combine(h, hashString(e->getDest()->getInfo()));
+            h = combine(h, hashDouble(e->getWeight()));
+            h = combine(h, e->getReverse() != nullptr);
+        }
+    }
+    for (double demand : csvInfo::citiesVector.getDemands()) {
+        h = combine(h, hashDouble(demand));
+    }
+    for (int maxDelivery : csvInfo::reservoirsVector.getMaxDeliveries()) {
+        h = combine(h, maxDelivery);
+    }
+    return h;
+}
+
+uint64_t ResultCache::hashNetwork(const FlowNetwork &net) {
+    uint64_t h = net.numVertices();
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        h = combine(h, net.getTail(a));
+        h = combine(h, net.getHead(a));
+        h = combine(h, hashDouble(net.getCapacity(a)));
+        h = combine(h, hashDouble(net.getFlow(a)));
+    }
+    return h;
+}
+
+uint64_t ResultCache::hashScenario(const Scenario &s) {
+    uint64_t h = s.changes.size();
+    for (auto &c : s.changes) {
+        h = combine(h, c.first);
+        h = combine(h, hashDouble(c.second));
+    }
+    return h;
+}
+
+bool ResultCache::findMaxFlow(uint64_t key, vector<vector<string>> &maxWater, vector<double> &flows) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = maxFlows.find(key);
+    if (it == maxFlows.end()) return false;
+    maxWater = it->second.maxWater;
+    flows = it->second.flows;
+    return true;
+}
+
+void ResultCache::storeMaxFlow(uint64_t key, const vector<vector<string>> &maxWater, const vector<double> &flows) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (maxFlows.size() >= MAX_ENTRIES) maxFlows.clear();
+    maxFlows[key].maxWater = maxWater;
+    maxFlows[key].flows = flows;
+}
+
+bool ResultCache::findScenario(uint64_t key, ScenarioResult &res) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = scenarios.find(key);
+    if (it == scenarios.end()) return false;
+    res = it->second;
+    return true;
+}
+
+void ResultCache::storeScenario(uint64_t key, const ScenarioResult &res) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (scenarios.size() >= MAX_ENTRIES) scenarios.clear();
+    scenarios[key] = res;
+}
+
+shared_ptr<const FlowNetwork> ResultCache::solvedNetworkLocked(uint64_t key) {
+    if (network == nullptr || key != networkKey) {
+        FlowNetwork solved = FlowNetwork::fromPipesGraph();
+        SolverTuner::solveExact(solved);
+        network = make_shared<const FlowNetwork>(move(solved));
+        networkKey = key;
+    }
+    return network;
+}
+
+shared_ptr<const FlowNetwork> ResultCache::solvedNetwork() {
+    std::lock_guard<std::mutex> guard(lock);
+    return solvedNetworkLocked(hashPipesGraph());
+}
+
+shared_ptr<const FlowDecomposition> ResultCache::solvedDecomposition(shared_ptr<const FlowNetwork> &net) {
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t key = hashPipesGraph();
+    net = solvedNetworkLocked(key);
+    if (decomposition == nullptr || decompositionKey != key) {
+        decomposition = make_shared<const FlowDecomposition>(*net);
+        decompositionKey = key;
+    }
+    return decomposition;
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    maxFlows.clear();
+    scenarios.clear();
+    network = nullptr;
+    networkKey = 0;
+    decomposition = nullptr;
+    decompositionKey = 0;
+}
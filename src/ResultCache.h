@@ -0,0 +1,165 @@
+#ifndef DA2324_PRJ1_G13_4_RESULTCACHE_H
+#define DA2324_PRJ1_G13_4_RESULTCACHE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "ScenarioEngine.h"
+#include "FlowDecomposition.h"
+
+/**
+ * @brief Results of previous computations, keyed by a hash of the state they were computed on.
+ *
+ * The key covers topology, capacities, demands and deliveries, so any edit of the network yields a
+ * different key. Keys are 64-bit hashes and hits are not compared with the full state, so a stale result
+ * is only returned if two states collide.
+ */
+class ResultCache {
+public:
+    /**
+     * @brief Hash of csvInfo::pipesGraph (vertices, pipes in order and their weights) together with
+     * the demand of every city and the max delivery of every reservoir
+     *
+     * Complexity: O(V + E)
+     *
+     * @return Hash
+     */
+    static uint64_t hashPipesGraph();
+
+    /**
+     * @brief Hash of the topology, capacities and flow of a network
+     *
+     * Complexity: O(V + E)
+     *
+     * @param net : Network
+     * @return Hash
+     */
+    static uint64_t hashNetwork(const FlowNetwork &net);
+
+    /**
+     * @brief Hash of the changes of a scenario (its name is not part of it)
+     *
+     * Complexity: O(k), k = number of changes
+     *
+     * @param s : Scenario
+     * @return Hash
+     */
+    static uint64_t hashScenario(const Scenario &s);
+
+    /**
+     * @brief Mixes a value into a hash
+     *
+     * Complexity: O(1)
+     *
+     * @param seed : Hash so far
+     * @param v : Value
+     * @return New hash
+     */
+    static uint64_t combine(uint64_t seed, uint64_t v);
+
+    /**
+     * @brief Looks up the result of AuxFunctions::MaxFlow
+     *
+     * Complexity: O(log n)
+     *
+     * @param key : Hash of pipesGraph
+     * @param maxWater : Max water per city (output)
+     * @param flows : Flow of every pipe, in vertexSet/adjacency order (output)
+     * @return True if found
+     */
+    static bool findMaxFlow(uint64_t key, vector<vector<string>> &maxWater, vector<double> &flows);
+
+    /**
+     * @brief Stores the result of AuxFunctions::MaxFlow
+     *
+     * Complexity: O(log n + E)
+     *
+     * @param key : Hash of pipesGraph
+     * @param maxWater : Max water per city
+     * @param flows : Flow of every pipe, in vertexSet/adjacency order
+     */
+    static void storeMaxFlow(uint64_t key, const vector<vector<string>> &maxWater, const vector<double> &flows);
+
+    /**
+     * @brief Looks up the result of a scenario
+     *
+     * Complexity: O(log n)
+     *
+     * @param key : Hash of the baseline combined with the hash of the scenario
+     * @param res : Result (output)
+     * @return True if found
+     */
+    static bool findScenario(uint64_t key, ScenarioResult &res);
+
+    /**
+     * @brief Stores the result of a scenario
+     *
+     * Complexity: O(log n + C)
+     *
+     * @param key : Hash of the baseline combined with the hash of the scenario
+     * @param res : Result
+     */
+    static void storeScenario(uint64_t key, const ScenarioResult &res);
+
+    /**
+     * @brief Get the network of pipesGraph with its max flow, solving it only if pipesGraph changed since the last call.
+     * The snapshot is never modified, so it stays valid and unchanged for as long as the caller holds it, even if
+     * another thread replaces the cached one.
+     *
+     * Complexity: O(V + E) if cached, O(V E^2) otherwise
+     *
+     * @return Solved network
+     */
+    static shared_ptr<const FlowNetwork> solvedNetwork();
+
+    /**
+     * @brief Get the decomposition into paths of the max flow of solvedNetwork, decomposing it only if it changed. The
+     * snapshots are never modified, like the one of solvedNetwork.
+     *
+     * Complexity: O(V + E) if cached, O(V E^2 + E * (V + paths)) otherwise
+     *
+     * @param net : Solved network the decomposition belongs to (output)
+     * @return Decomposition
+     */
+    static shared_ptr<const FlowDecomposition> solvedDecomposition(shared_ptr<const FlowNetwork> &net);
+
+    /**
+     * @brief Drops every stored result
+     *
+     * Complexity: O(n)
+     */
+    static void clear();
+
+private:
+    /**
+     * @brief Stored result of AuxFunctions::MaxFlow
+     */
+    class MaxFlowEntry {
+    public:
+        vector<vector<string>> maxWater;
+        vector<double> flows;
+    };
+
+    static const size_t MAX_ENTRIES = 4096;
+
+    /**
+     * @brief Get the cached solved network, solving it again if its key is not the one given. The lock must be held.
+     *
+     * Complexity: O(1) if cached, O(V E^2) otherwise
+     *
+     * @param key : Hash of pipesGraph
+     * @return Solved network
+     */
+    static shared_ptr<const FlowNetwork> solvedNetworkLocked(uint64_t key);
+
+    static map<uint64_t, MaxFlowEntry> maxFlows;
+    static map<uint64_t, ScenarioResult> scenarios;
+    static uint64_t networkKey;
+    static shared_ptr<const FlowNetwork> network;
+    static uint64_t decompositionKey;
+    static shared_ptr<const FlowDecomposition> decomposition;
+    static std::mutex lock;
+};
+
+#endif //DA2324_PRJ1_G13_4_RESULTCACHE_H
@@ -0,0 +1,282 @@
+#include "ResultWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+OutputFormat ResultWriter::format = CSV_FORMAT;
+
+AsyncFile::~AsyncFile() {
+    close();
+}
+
+bool AsyncFile::open(const string &path) {
+    out.open(path, ios::binary);
+    if (!out.is_open()) return false;
+    closing = false;
+    worker = thread(&AsyncFile::run, this);
+    return true;
+}
+
+void AsyncFile::write(string &chunk) {
+    unique_lock<mutex> guard(lock);
+    space.wait(guard, [this]() { return pending.size() < MAX_PENDING; });
+    pending.push_back(std::move(chunk));
+    chunk.clear();
+    ready.notify_one();
+}
+
+void AsyncFile::close() {
+    if (!worker.joinable()) return;
+    {
+        lock_guard<mutex> guard(lock);
+        closing = true;
+    }
+    ready.notify_one();
+    worker.join();
+    out.close();
+}
+
+void AsyncFile::run() {
+    while (true) {
+        string chunk;
+        {
+            unique_lock<mutex> guard(lock);
+            ready.wait(guard, [this]() { return closing || !pending.empty(); });
+            if (pending.empty()) return;
+            chunk = std::move(pending.front());
+            pending.pop_front();
+        }
+        space.notify_one();
+        out.write(chunk.data(), (streamsize) chunk.size());
+    }
+}
+
+ResultWriter::ResultWriter(const vector<ResultColumn> &columns): columns(columns) {}
+
+ResultWriter::~ResultWriter() {
+    close();
+}
+
+unique_ptr<ResultWriter> ResultWriter::open(const string &basePath, const vector<ResultColumn> &columns) {
+    return open(basePath, columns, format);
+}
+
+unique_ptr<ResultWriter> ResultWriter::open(const string &basePath, const vector<ResultColumn> &columns, OutputFormat f) {
+    unique_ptr<ResultWriter> writer;
+    switch (f) {
+        case JSON_LINES_FORMAT:
+            writer.reset(new JsonLinesWriter(columns));
+            break;
+        case COLUMNAR_FORMAT:
+            writer.reset(new ColumnarWriter(columns));
+            break;
+        default:
+            writer.reset(new CsvWriter(columns));
+    }
+    if (!writer->file.open(basePath + extension(f))) {
+        cerr << "Error: Unable to open the file." << endl;
+        return nullptr;
+    }
+    writer->writeHeader();
+    return writer;
+}
+
+string ResultWriter::extension(OutputFormat f) {
+    switch (f) {
+        case JSON_LINES_FORMAT:
+            return ".jsonl";
+        case COLUMNAR_FORMAT:
+            return ".col";
+        default:
+            return ".csv";
+    }
+}
+
+ResultWriter &ResultWriter::add(const string &value) {
+    Cell c;
+    c.text = value;
+    if (columns[row.size()].type == NUMBER_COLUMN) {
+        try {
+            c.number = stod(value);
+        }
+        catch (const exception &) {
+            c.number = numeric_limits<double>::quiet_NaN();    // missing value
+        }
+    }
+    row.push_back(c);
+    return *this;
+}
+
+/**
+ * Shortest text that reads back as exactly the same number (at most 17 significant digits). Whole numbers keep all
+ * their digits (1000, not 1e+03).
+ */
+static string roundTripText(double value) {
+    char text[32];
+    int digits = 1;
+    if (isfinite(value) && std::abs(value) >= 1) digits = min(17, (int) floor(log10(std::abs(value))) + 1);
+    for (; digits <= 17; digits++) {
+        snprintf(text, sizeof(text), "%.*g", digits, value);
+        if (strtod(text, nullptr) == value) break;
+    }
+    return text;
+}
+
+ResultWriter &ResultWriter::add(double value) {
+    if (value == 0) value = 0;    // no "-0"
+    Cell c;
+    c.text = roundTripText(value);
+    c.number = value;
+    row.push_back(c);
+    return *this;
+}
+
+void ResultWriter::endRow() {
+    Cell missing;
+    missing.number = numeric_limits<double>::quiet_NaN();    // missing value, not 0
+    while (row.size() < columns.size()) row.push_back(missing);
+    writeRow();
+    row.clear();
+    flushBuffer(false);
+}
+
+void ResultWriter::close() {
+    if (closed) return;
+    closed = true;
+    finish();
+    flushBuffer(true);
+    file.close();
+}
+
+void ResultWriter::finish() {}
+
+void ResultWriter::flushBuffer(bool force) {
+    if (buffer.size() >= CHUNK_SIZE || (force && !buffer.empty())) file.write(buffer);
+}
+
+CsvWriter::CsvWriter(const vector<ResultColumn> &columns): ResultWriter(columns) {}
+
+void CsvWriter::append(const string &value) {
+    if (value.find_first_of(",\"\r\n") == string::npos) {
+        buffer += value;
+        return;
+    }
+    buffer += '"';
+    for (char c : value) {
+        if (c == '"') buffer += '"';
+        buffer += c;
+    }
+    buffer += '"';
+}
+
+void CsvWriter::writeHeader() {
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (i > 0) buffer += ',';
+        append(columns[i].name);
+    }
+    buffer += '\n';
+}
+
+void CsvWriter::writeRow() {
+    for (size_t i = 0; i < row.size(); i++) {
+        if (i > 0) buffer += ',';
+        append(row[i].text);
+    }
+    buffer += '\n';
+}
+
+JsonLinesWriter::JsonLinesWriter(const vector<ResultColumn> &columns): ResultWriter(columns) {}
+
+void JsonLinesWriter::appendString(string &out, const string &value) {
+    out += '"';
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char) c;
+        }
+        else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        }
+        else out += (char) c;
+    }
+    out += '"';
+}
+
+void JsonLinesWriter::writeHeader() {}
+
+void JsonLinesWriter::writeRow() {
+    buffer += '{';
+    for (size_t i = 0; i < row.size(); i++) {
+        if (i > 0) buffer += ',';
+        appendString(buffer, columns[i].name);
+        buffer += ':';
+        if (columns[i].type == TEXT_COLUMN) appendString(buffer, row[i].text);
+        else if (row[i].text.empty() || !isfinite(row[i].number)) buffer += "null";    // JSON has no nan or inf
+        else buffer += roundTripText(row[i].number);
+    }
+    buffer += "}\n";
+}
+
+ColumnarWriter::ColumnarWriter(const vector<ResultColumn> &columns):
+        ResultWriter(columns), numbers(columns.size()), offsets(columns.size()), texts(columns.size()) {}
+
+ColumnarWriter::~ColumnarWriter() {
+    close();
+}
+
+void ColumnarWriter::appendUint32(uint32_t v) {
+    for (int i = 0; i < 4; i++) buffer += (char) ((v >> (8 * i)) & 0xff);
+}
+
+void ColumnarWriter::writeHeader() {
+    buffer.append("DACOL1\0\0", 8);
+    appendUint32((uint32_t) columns.size());
+    for (const ResultColumn &c : columns) {
+        buffer += (char) (c.type == NUMBER_COLUMN ? 1 : 0);
+        appendUint32((uint32_t) c.name.size());
+        buffer += c.name;
+    }
+}
+
+void ColumnarWriter::writeRow() {
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].type == NUMBER_COLUMN) numbers[i].push_back(row[i].number);
+        else {
+            texts[i] += row[i].text;
+            offsets[i].push_back((uint32_t) texts[i].size());
+        }
+    }
+    if (++rows == BLOCK_ROWS) writeBlock();
+}
+
+void ColumnarWriter::writeBlock() {
+    if (rows == 0) return;
+    appendUint32(rows);
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].type == NUMBER_COLUMN) {
+            for (double d : numbers[i]) {
+                uint64_t bits;
+                memcpy(&bits, &d, sizeof(bits));
+                for (int b = 0; b < 8; b++) buffer += (char) ((bits >> (8 * b)) & 0xff);
+            }
+            numbers[i].clear();
+        }
+        else {
+            for (uint32_t o : offsets[i]) appendUint32(o);
+            buffer += texts[i];
+            offsets[i].clear();
+            texts[i].clear();
+        }
+    }
+    rows = 0;
+}
+
+void ColumnarWriter::finish() {
+    writeBlock();
+    appendUint32(0);
+}
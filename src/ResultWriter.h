@@ -0,0 +1,359 @@
+#ifndef DA2324_PRJ1_G13_4_RESULTWRITER_H
+#define DA2324_PRJ1_G13_4_RESULTWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief Format of the files written by the analyses
+ */
+enum OutputFormat { CSV_FORMAT, JSON_LINES_FORMAT, COLUMNAR_FORMAT };
+
+/**
+ * @brief Type of the values of a column
+ */
+enum ColumnType { TEXT_COLUMN, NUMBER_COLUMN };
+
+/**
+ * @brief Column of a result file
+ */
+class ResultColumn {
+public:
+    /**
+     * @brief Column name
+     */
+    string name;
+
+    /**
+     * @brief Value type
+     */
+    ColumnType type;
+};
+
+/**
+ * @brief File written by a background thread. Data is handed over in large chunks, so the thread producing results only
+ * waits for the disk when too many chunks are pending (which bounds memory).
+ */
+class AsyncFile {
+public:
+    /**
+     * @brief Destructor, closes the file
+     *
+     * Complexity: O(pending chunks)
+     */
+    ~AsyncFile();
+
+    /**
+     * @brief Opens a file for writing and starts its writer thread
+     *
+     * Complexity: O(1)
+     *
+     * @param path : File path
+     * @return True if the file could be opened
+     */
+    bool open(const string &path);
+
+    /**
+     * @brief Queues a chunk to be written
+     *
+     * Complexity: O(1), unless MAX_PENDING chunks are already waiting
+     *
+     * @param chunk : Data (moved)
+     */
+    void write(string &chunk);
+
+    /**
+     * @brief Writes every pending chunk and closes the file
+     *
+     * Complexity: O(pending chunks)
+     */
+    void close();
+
+private:
+    static const size_t MAX_PENDING = 16;
+
+    ofstream out;
+    thread worker;
+    mutex lock;
+    condition_variable ready;
+    condition_variable space;
+    deque<string> pending;
+    bool closing = false;
+
+    /**
+     * @brief Writes chunks until the file is closed
+     *
+     * Complexity: O(total size)
+     */
+    void run();
+};
+
+/**
+ * @brief Buffered writer of a table of results. Rows are built with add(...) and endRow(), formatted into a memory
+ * buffer and written by an AsyncFile.
+ *
+ * The format is chosen by ResultWriter::format (or explicitly) and decides the extension of the file:
+ * - CSV (.csv): header line and one line per row.
+ * - JSON Lines (.jsonl): one object per row, numbers unquoted (null if missing, nan or infinite).
+ * - Columnar (.col): binary, for very large outputs. "DACOL1\0\0", uint32 number of columns and for each one uint8 type
+ *   (0 text, 1 number), uint32 name length and name. Then blocks of up to BLOCK_ROWS rows: uint32 rows and, per column,
+ *   rows float64 values (numbers) or rows uint32 end offsets followed by the bytes (text). A block of 0 rows ends the file.
+ *   Integers are little endian.
+ */
+class ResultWriter {
+public:
+    /**
+     * @brief Format used by open when none is given
+     */
+    static OutputFormat format;
+
+    /**
+     * @brief Destructor, closes the file
+     *
+     * Complexity: O(buffered data)
+     */
+    virtual ~ResultWriter();
+
+    /**
+     * @brief Creates a writer of the format in ResultWriter::format
+     *
+     * Complexity: O(columns)
+     *
+     * @param basePath : File path without extension
+     * @param columns : Columns of the table
+     * @return Writer, or nullptr if the file could not be opened
+     */
+    static unique_ptr<ResultWriter> open(const string &basePath, const vector<ResultColumn> &columns);
+
+    /**
+     * @brief Creates a writer of a given format
+     *
+     * Complexity: O(columns)
+     *
+     * @param basePath : File path without extension
+     * @param columns : Columns of the table
+     * @param f : Format
+     * @return Writer, or nullptr if the file could not be opened
+     */
+    static unique_ptr<ResultWriter> open(const string &basePath, const vector<ResultColumn> &columns, OutputFormat f);
+
+    /**
+     * @brief Get the file extension of a format
+     *
+     * Complexity: O(1)
+     *
+     * @param f : Format
+     * @return Extension, with the dot
+     */
+    static string extension(OutputFormat f = format);
+
+    /**
+     * @brief Adds a text value (or an already formatted number) to the current row
+     *
+     * Complexity: O(length)
+     *
+     * @param value : Value
+     * @return This writer
+     */
+    ResultWriter &add(const string &value);
+
+    /**
+     * @brief Adds a number to the current row, written as the shortest text that reads back as the same number
+     *
+     * Complexity: O(1)
+     *
+     * @param value : Value
+     * @return This writer
+     */
+    ResultWriter &add(double value);
+
+    /**
+     * @brief Ends the current row, writing the values not added as missing (empty, not 0)
+     *
+     * Complexity: O(row size)
+     */
+    void endRow();
+
+    /**
+     * @brief Writes what is still buffered and closes the file
+     *
+     * Complexity: O(buffered data)
+     */
+    void close();
+
+protected:
+    /**
+     * @brief Value of a row
+     */
+    class Cell {
+    public:
+        string text;
+        double number = 0;
+    };
+
+    static const size_t CHUNK_SIZE = 1 << 16;
+
+    vector<ResultColumn> columns;
+    vector<Cell> row;
+    string buffer;
+    AsyncFile file;
+    bool closed = false;
+
+    /**
+     * @brief Constructor
+     *
+     * Complexity: O(columns)
+     *
+     * @param columns : Columns of the table
+     */
+    explicit ResultWriter(const vector<ResultColumn> &columns);
+
+    /**
+     * @brief Formats the header into the buffer
+     *
+     * Complexity: O(columns)
+     */
+    virtual void writeHeader() = 0;
+
+    /**
+     * @brief Formats the current row into the buffer
+     *
+     * Complexity: O(row size)
+     */
+    virtual void writeRow() = 0;
+
+    /**
+     * @brief Formats what is still pending and the end of the file into the buffer
+     *
+     * Complexity: O(pending rows)
+     */
+    virtual void finish();
+
+    /**
+     * @brief Hands the buffer to the file if it is large enough (or always if forced)
+     *
+     * Complexity: O(1)
+     *
+     * @param force : Whether to hand it over even if small
+     */
+    void flushBuffer(bool force);
+};
+
+/**
+ * @brief Writer of CSV files
+ */
+class CsvWriter : public ResultWriter {
+public:
+    /**
+     * @brief Constructor
+     *
+     * Complexity: O(columns)
+     *
+     * @param columns : Columns of the table
+     */
+    explicit CsvWriter(const vector<ResultColumn> &columns);
+
+protected:
+    void writeHeader() override;
+    void writeRow() override;
+
+private:
+    /**
+     * @brief Appends a value to the buffer, quoted if it has commas, quotes or line breaks
+     *
+     * Complexity: O(length)
+     *
+     * @param value : Value
+     */
+    void append(const string &value);
+};
+
+/**
+ * @brief Writer of JSON Lines files
+ */
+class JsonLinesWriter : public ResultWriter {
+public:
+    /**
+     * @brief Constructor
+     *
+     * Complexity: O(columns)
+     *
+     * @param columns : Columns of the table
+     */
+    explicit JsonLinesWriter(const vector<ResultColumn> &columns);
+
+    /**
+     * @brief Appends a value as a JSON string, quoted and escaped (also used by the query server)
+     *
+     * Complexity: O(length)
+     *
+     * @param out : Text to append to
+     * @param value : Value
+     */
+    static void appendString(string &out, const string &value);
+
+protected:
+    void writeHeader() override;
+    void writeRow() override;
+};
+
+/**
+ * @brief Writer of columnar binary files
+ */
+class ColumnarWriter : public ResultWriter {
+public:
+    /**
+     * @brief Constructor
+     *
+     * Complexity: O(columns)
+     *
+     * @param columns : Columns of the table
+     */
+    explicit ColumnarWriter(const vector<ResultColumn> &columns);
+
+    /**
+     * @brief Destructor, writes the last block and closes the file
+     *
+     * Complexity: O(pending rows)
+     */
+    ~ColumnarWriter() override;
+
+protected:
+    void writeHeader() override;
+    void writeRow() override;
+    void finish() override;
+
+private:
+    static const uint32_t BLOCK_ROWS = 65536;
+
+    uint32_t rows = 0;
+    vector<vector<double>> numbers;
+    vector<vector<uint32_t>> offsets;
+    vector<string> texts;
+
+    /**
+     * @brief Formats the rows of the current block into the buffer
+     *
+     * Complexity: O(block size)
+     */
+    void writeBlock();
+
+    /**
+     * @brief Appends a little endian uint32 to the buffer
+     *
+     * Complexity: O(1)
+     *
+     * @param v : Value
+     */
+    void appendUint32(uint32_t v);
+};
+
+#endif //DA2324_PRJ1_G13_4_RESULTWRITER_H
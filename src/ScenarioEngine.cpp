@@ -0,0 +1,251 @@
+#include "ScenarioEngine.h"
+#include "csvInfo.h"
+#include "ResultCache.h"
+#include "ResultWriter.h"
+#include "TextParsing.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <limits>
+
+vector<Scenario> ScenarioEngine::readScenarios(const string &path, const FlowNetwork &net) {
+    vector<Scenario> scenarios;
+    fstream file;
+    file.open(path);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open the file." << endl;
+        return scenarios;
+    }
+
+    string line;
+    int n = 0;
+    while (getline(file, line)) {
+        n++;
+        line = TextParsing::trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        Scenario s;
+        string error;
+        if (parseScenario(line, net, s, error)) {
+            s.line = n;
+            scenarios.push_back(s);
+        }
+        else {
+            cerr << "Error: line " << n << ": " << error << endl;
+        }
+    }
+    file.close();
+    return scenarios;
+}
+
+bool ScenarioEngine::parseScenario(const string &text, const FlowNetwork &net, Scenario &s, string &error) {
+    size_t colon = text.find(':');
+    if (colon == string::npos) {
+        error = "missing ':' after the scenario name";
+        return false;
+    }
+    s.name = TextParsing::trim(text.substr(0, colon));
+    s.changes.clear();
+    map<FlowId, double> capacities;    // capacity of each changed arc so far, so that actions compose
+
+    stringstream actions(text.substr(colon + 1));
+    string action;
+    while (getline(actions, action, ';')) {
+        if (TextParsing::trim(action).empty()) continue;
+        stringstream tokens(action);
+        string verb, target, value, extra;
+        tokens >> verb >> target >> value >> extra;
+
+        double amount = 0;
+        if (verb == "scale" || verb == "set") {
+            if (verb == "scale" && !value.empty() && value.back() == '%') value.pop_back();
+            if (!TextParsing::parseNumber(value, amount, error)) {
+                error += " in '" + TextParsing::trim(action) + "'";
+                return false;
+            }
+            if (amount < 0) {
+                error = "negative value in '" + TextParsing::trim(action) + "'";
+                return false;
+            }
+            if (verb == "scale") amount /= 100.0;
+        }
+        else if (verb != "close") {
+            error = "unknown action '" + verb + "'";
+            return false;
+        }
+        string unexpected = verb == "close" ? value : extra;
+        if (!unexpected.empty()) {
+            error = "unexpected '" + unexpected + "' in '" + TextParsing::trim(action) + "'";
+            return false;
+        }
+
+        vector<FlowId> arcs;
+        size_t arrow = target.find("->");
+        if (arrow != string::npos) {
+            FlowId a = net.findVertex(target.substr(0, arrow));
+            FlowId b = net.findVertex(target.substr(arrow + 2));
+            if (a != NO_ID && b != NO_ID) arcs = net.findPipeArcs(a, b);
+            if (arcs.empty()) {
+                error = "unknown pipe '" + target + "'";
+                return false;
+            }
+        }
+        else {
+            FlowId id = net.findVertex(target);
+            if (id == NO_ID) {
+                error = "unknown code '" + target + "'";
+                return false;
+            }
+            Vertex* v = csvInfo::pipesGraph.findVertex(target);    // nullptr for stations added by edits
+            if (v != nullptr && v->getType() == 1) arcs.push_back(net.getReservoirArc(v->getPos()));
+            else if (v != nullptr && v->getType() == 0) arcs.push_back(net.getCityArc(v->getPos()));
+            else if (verb == "close") {
+                for (FlowId a = net.firstArc(id); a != NO_ID; a = net.nextArc(a)) {
+                    if (net.isPipe(a)) arcs.push_back(a);
+                    else if (net.isPipe(a ^ 1)) arcs.push_back(a ^ 1);
+                }
+            }
+            else {
+                error = "pumping stations can only be closed";
+                return false;
+            }
+        }
+
+        for (FlowId a : arcs) {
+            if (capacities.find(a) == capacities.end()) capacities[a] = net.getCapacity(a);
+            if (verb == "close") capacities[a] = 0;
+            else if (verb == "scale") capacities[a] *= amount;
+            else capacities[a] = amount;
+        }
+    }
+
+    for (auto &c : capacities) {
+        s.changes.emplace_back(c.first, c.second);
+    }
+    return true;
+}
+
+vector<Scenario> ScenarioEngine::reservoirRemovalScenarios(const FlowNetwork &net) {
+    vector<Scenario> scenarios;
+    for (int i = 0; i < (int) csvInfo::reservoirsVector.size(); i++) {
+        Scenario s;
+        s.name = csvInfo::reservoirsVector[i].getCode();
+        s.changes.emplace_back(net.getReservoirArc(i), 0);
+        scenarios.push_back(s);
+    }
+    return scenarios;
+}
+
+template <class Cap>
+ScenarioResult ScenarioEngine::evaluate(const BasicFlowNetwork<Cap> &baseline, const Scenario &s, const NetworkRegions &regions) {
+    BasicFlowNetwork<Cap> net = baseline;
+    vector<int> changed;
+    bool everywhere = false;
+    for (auto &c : s.changes) {
+        net.setCapacity(c.first, (Cap) c.second);
+        int r = regions.getArcRegion(c.first);
+        if (r < 0) everywhere = true;
+        else if (find(changed.begin(), changed.end(), r) == changed.end()) changed.push_back(r);
+    }
+
+    // the other regions keep their baseline max flow
+    if (everywhere) net.maxFlow();
+    else {
+        for (int r : changed) regions.solveRegion(net, r);
+    }
+
+    ScenarioResult res;
+    res.name = s.name;
+    res.maxFlow = (double) net.getFlowValue();
+    res.cityFlows = net.getCityFlows();
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        res.demands.push_back((double) net.getCapacity(net.getCityArc(i)));
+    }
+    return res;
+}
+
+template <class Cap>
+void ScenarioEngine::evaluateAllWith(const BasicFlowNetwork<Cap> &baseline, uint64_t baselineKey, const vector<Scenario> &scenarios,
+                                     unsigned threads, vector<ScenarioResult> &results) {
+    NetworkRegions regions(baseline);
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < scenarios.size(); i = next++) {
+            uint64_t key = ResultCache::combine(baselineKey, ResultCache::hashScenario(scenarios[i]));
+            if (!ResultCache::findScenario(key, results[i])) {
+                results[i] = evaluate(baseline, scenarios[i], regions);
+                ResultCache::storeScenario(key, results[i]);
+            }
+            results[i].name = scenarios[i].name;
+        }
+    };
+
+    vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+vector<ScenarioResult> ScenarioEngine::evaluateAll(const FlowNetwork &baseline, const vector<Scenario> &scenarios, unsigned threads) {
+    vector<ScenarioResult> results(scenarios.size());
+    if (threads == 0) threads = max(1u, std::thread::hardware_concurrency());
+    threads = min(threads, (unsigned) max((size_t) 1, scenarios.size()));
+
+    uint64_t baselineKey = ResultCache::hashNetwork(baseline);
+    switch (getCapacityKind(baseline, scenarios)) {
+        case INT32_CAPACITY:
+            evaluateAllWith(BasicFlowNetwork<int32_t>(baseline), baselineKey, scenarios, threads, results);
+            break;
+        case INT64_CAPACITY:
+            evaluateAllWith(BasicFlowNetwork<int64_t>(baseline), baselineKey, scenarios, threads, results);
+            break;
+        default:
+            evaluateAllWith(baseline, baselineKey, scenarios, threads, results);
+    }
+    return results;
+}
+
+CapacityKind ScenarioEngine::getCapacityKind(const FlowNetwork &baseline, const vector<Scenario> &scenarios) {
+    if (baseline.getCapacityKind() == DOUBLE_CAPACITY) return DOUBLE_CAPACITY;
+
+    // same bound as FlowCore::getCapacityKind, with every change counted on top of the baseline capacities
+    double total = 0;
+    for (FlowId a = 0; a < baseline.numArcs(); a += 2) {
+        total += std::fabs(baseline.getCapacity(a));
+    }
+    double changed = 0;
+    for (const Scenario &s : scenarios) {
+        double sum = 0;
+        for (auto &c : s.changes) {
+            if (c.second != std::floor(c.second)) return DOUBLE_CAPACITY;
+            sum += std::fabs(c.second);
+        }
+        changed = max(changed, sum);
+    }
+    total += changed;
+    if (total < (double) (std::numeric_limits<int32_t>::max() / 2)) return INT32_CAPACITY;
+    if (total < (double) (std::numeric_limits<int64_t>::max() / 2)) return INT64_CAPACITY;
+    return DOUBLE_CAPACITY;
+}
+
+void ScenarioEngine::writeDeficitReport(const string &path, const vector<ScenarioResult> &results, const vector<double> &baselineFlows) {
+    unique_ptr<ResultWriter> file = ResultWriter::open(path, {{"Scenario", TEXT_COLUMN}, {"CityName", TEXT_COLUMN},
+                                                              {"CityCode", TEXT_COLUMN}, {"Demand", NUMBER_COLUMN},
+                                                              {"BaselineWater", NUMBER_COLUMN}, {"Water", NUMBER_COLUMN},
+                                                              {"Deficit", NUMBER_COLUMN}});
+    if (file == nullptr) return;
+    for (const ScenarioResult &r : results) {
+        for (int i = 0; i < (int) r.cityFlows.size(); i++) {
+            long long water = std::llround(r.cityFlows[i]);
+            if (water >= r.demands[i]) continue;
+            file->add(r.name).add(csvInfo::citiesVector[i].getCity()).add(csvInfo::citiesVector[i].getCode())
+                 .add(r.demands[i]).add((double) std::llround(baselineFlows[i])).add((double) water).add(water - r.demands[i]);
+            file->endRow();
+        }
+    }
+    file->close();
+}
@@ -0,0 +1,166 @@
+#ifndef DA2324_PRJ1_G13_4_SCENARIOENGINE_H
+#define DA2324_PRJ1_G13_4_SCENARIOENGINE_H
+
+#include "FlowNetwork.h"
+#include "NetworkRegions.h"
+
+/**
+ * @brief A what-if scenario, already resolved to capacity changes of the network.
+ *
+ * Scenario files have one scenario per line, "name: action; action; ...", where each action is one of
+ *   close CODE | close A->B            (reservoir, station, city or pipe out of service)
+ *   scale CODE 60% | scale A->B 60%    (reservoir delivery, city demand or pipe capacity)
+ *   set CODE 100 | set A->B 100        (absolute value of the above)
+ * Values are finite and not negative, and the '%' of scale may be left out. Empty lines and lines starting with '#' are
+ * ignored. Closing or changing a bidirectional pipe affects both directions.
+ */
+class Scenario {
+public:
+    /**
+     * @brief Scenario name
+     */
+    string name;
+
+    /**
+     * @brief Line of the scenario file
+     */
+    int line = 0;
+
+    /**
+     * @brief Arcs of the network and their new capacity
+     */
+    vector<pair<FlowId, double>> changes;
+};
+
+/**
+ * @brief Outcome of a scenario
+ */
+class ScenarioResult {
+public:
+    /**
+     * @brief Scenario name
+     */
+    string name;
+
+    /**
+     * @brief Total water delivered
+     */
+    double maxFlow = 0;
+
+    /**
+     * @brief Water reaching each city, indexed like citiesVector
+     */
+    vector<double> cityFlows;
+
+    /**
+     * @brief Demand of each city under the scenario, indexed like citiesVector
+     */
+    vector<double> demands;
+};
+
+/**
+ * @brief Evaluates what-if scenarios in bulk, in parallel, each one warm-started from the baseline max flow.
+ */
+class ScenarioEngine {
+public:
+    /**
+     * @brief Reads a scenario file. Lines with errors are reported and skipped.
+     *
+     * Complexity: O(L * n), L = number of lines
+     *
+     * @param path : Scenario file
+     * @param net : Network the scenarios refer to
+     * @return Scenarios
+     */
+    static vector<Scenario> readScenarios(const string &path, const FlowNetwork &net);
+
+    /**
+     * @brief Parses one scenario line
+     *
+     * Complexity: O(n) per action
+     *
+     * @param text : Line of the file
+     * @param net : Network the scenario refers to
+     * @param s : Parsed scenario (output)
+     * @param error : Description of the problem, if any (output)
+     * @return True if the line is a valid scenario
+     */
+    static bool parseScenario(const string &text, const FlowNetwork &net, Scenario &s, string &error);
+
+    /**
+     * @brief Builds one scenario per reservoir, with that reservoir out of commission
+     *
+     * Complexity: O(R)
+     *
+     * @param net : Network the scenarios refer to
+     * @return Scenarios, indexed like reservoirsVector
+     */
+    static vector<Scenario> reservoirRemovalScenarios(const FlowNetwork &net);
+
+    /**
+     * @brief Applies a scenario to a copy of the baseline and re-runs the max flow from the baseline flow, only in the
+     * regions the scenario changes
+     *
+     * Complexity: O(V + E + V_r E_r^2), V_r and E_r = vertices and arcs of the changed regions
+     *
+     * @param baseline : Solved network
+     * @param s : Scenario
+     * @param regions : Regions of the baseline
+     * @return Result
+     */
+    template <class Cap>
+    static ScenarioResult evaluate(const BasicFlowNetwork<Cap> &baseline, const Scenario &s, const NetworkRegions &regions);
+
+    /**
+     * @brief Evaluates all the scenarios over a pool of threads. Scenarios already evaluated on the same baseline
+     * are taken from ResultCache.
+     *
+     * Complexity: O(S V E^2 / threads)
+     *
+     * @param baseline : Solved network
+     * @param scenarios : Scenarios
+     * @param threads : Number of threads (0 for one per core)
+     * @return Results, in the same order as the scenarios
+     */
+    static vector<ScenarioResult> evaluateAll(const FlowNetwork &baseline, const vector<Scenario> &scenarios, unsigned threads = 0);
+
+    /**
+     * @brief Get the narrowest capacity type able to evaluate all the scenarios exactly
+     *
+     * Complexity: O(E + S k), k = number of changes per scenario
+     *
+     * @param baseline : Solved network
+     * @param scenarios : Scenarios
+     * @return Capacity kind
+     */
+    static CapacityKind getCapacityKind(const FlowNetwork &baseline, const vector<Scenario> &scenarios);
+
+    /**
+     * @brief Writes every city in deficit, for every scenario, to a result file
+     *
+     * Complexity: O(S * C)
+     *
+     * @param path : Output file, without extension
+     * @param results : Scenario results
+     * @param baselineFlows : Water reaching each city without any change
+     */
+    static void writeDeficitReport(const string &path, const vector<ScenarioResult> &results, const vector<double> &baselineFlows);
+
+private:
+    /**
+     * @brief Evaluates the scenarios not in ResultCache over a pool of threads
+     *
+     * Complexity: O(S V E^2 / threads)
+     *
+     * @param baseline : Solved network
+     * @param baselineKey : Hash of the baseline
+     * @param scenarios : Scenarios
+     * @param threads : Number of threads
+     * @param results : Results, in the same order as the scenarios (output)
+     */
+    template <class Cap>
+    static void evaluateAllWith(const BasicFlowNetwork<Cap> &baseline, uint64_t baselineKey, const vector<Scenario> &scenarios,
+                                unsigned threads, vector<ScenarioResult> &results);
+};
+
+#endif //DA2324_PRJ1_G13_4_SCENARIOENGINE_H
@@ -0,0 +1,101 @@
+#include "Sensitivity.h"
+#include "csvInfo.h"
+#include "ResultWriter.h"
+#include <algorithm>
+
+vector<SensitivityEntry> Sensitivity::listElements(const FlowNetwork &net) {
+    vector<SensitivityEntry> entries;
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        if (!net.isPipe(a)) continue;
+        vector<FlowId> arcs = net.findPipeArcs(net.getTail(a), net.getHead(a));
+        if (arcs.empty() || *min_element(arcs.begin(), arcs.end()) != a) continue;    // other direction already listed
+
+        SensitivityEntry e;
+        e.type = "Pipe";
+        e.element = net.getCode(net.getTail(a)) + "->" + net.getCode(net.getHead(a));
+        e.arcs = arcs;
+        e.capacity = net.getCapacity(a);
+        for (FlowId arc : arcs) e.flow = max(e.flow, net.getFlow(arc));
+        entries.push_back(e);
+    }
+    for (int i = 0; i < (int) csvInfo::reservoirsVector.size(); i++) {
+        SensitivityEntry e;
+        e.type = "Reservoir";
+        e.element = csvInfo::reservoirsVector[i].getCode();
+        e.arcs.push_back(net.getReservoirArc(i));
+        e.capacity = net.getCapacity(e.arcs[0]);
+        e.flow = net.getFlow(e.arcs[0]);
+        entries.push_back(e);
+    }
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        SensitivityEntry e;
+        e.type = "City";
+        e.element = csvInfo::citiesVector[i].getCode();
+        e.arcs.push_back(net.getCityArc(i));
+        e.capacity = net.getCapacity(e.arcs[0]);
+        e.flow = net.getFlow(e.arcs[0]);
+        entries.push_back(e);
+    }
+    return entries;
+}
+
+vector<SensitivityEntry> Sensitivity::analyse(const FlowNetwork &baseline, double percent, int &solves) {
+    vector<SensitivityEntry> entries = listElements(baseline);
+    vector<bool> sourceSide = baseline.getSourceSide();
+    vector<bool> sinkSide = baseline.getSinkSide();
+    bool exact = baseline.getCapacityKind() != DOUBLE_CAPACITY;
+    double initial = baseline.getFlowValue();
+
+    // changes that can not be read from the residual network: (entry, +1 for increase / -1 for decrease)
+    vector<Scenario> scenarios;
+    vector<pair<int, int>> pending;
+    for (int i = 0; i < (int) entries.size(); i++) {
+        SensitivityEntry &e = entries[i];
+        e.delta = percent > 0 ? e.capacity * percent / 100.0 : 1;
+
+        bool crossing = false;
+        bool overloaded = false;
+        for (FlowId a : e.arcs) {
+            if (sourceSide[baseline.getTail(a)] && sinkSide[baseline.getHead(a)]) crossing = true;
+            if (baseline.getFlow(a) > baseline.getCapacity(a) - e.delta + 1e-9) overloaded = true;
+        }
+
+        if (crossing && percent <= 0 && exact) e.gain = 1;
+        else if (crossing && e.delta > 0) {
+            Scenario s;
+            s.name = e.element;
+            for (FlowId a : e.arcs) s.changes.emplace_back(a, baseline.getCapacity(a) + e.delta);
+            scenarios.push_back(s);
+            pending.emplace_back(i, 1);
+        }
+
+        if (overloaded && e.flow > 1e-9) {
+            Scenario s;
+            s.name = e.element;
+            for (FlowId a : e.arcs) s.changes.emplace_back(a, max(0.0, baseline.getCapacity(a) - e.delta));
+            scenarios.push_back(s);
+            pending.emplace_back(i, -1);
+        }
+    }
+
+    vector<ScenarioResult> results = ScenarioEngine::evaluateAll(baseline, scenarios);
+    for (int k = 0; k < (int) pending.size(); k++) {
+        SensitivityEntry &e = entries[pending[k].first];
+        if (pending[k].second > 0) e.gain = results[k].maxFlow - initial;
+        else e.loss = initial - results[k].maxFlow;
+    }
+    solves = (int) scenarios.size();
+    return entries;
+}
+
+void Sensitivity::writeReport(const string &path, const vector<SensitivityEntry> &entries) {
+    unique_ptr<ResultWriter> file = ResultWriter::open(path, {{"Type", TEXT_COLUMN}, {"Element", TEXT_COLUMN},
+                                                              {"Capacity", NUMBER_COLUMN}, {"Flow", NUMBER_COLUMN},
+                                                              {"Delta", NUMBER_COLUMN}, {"Gain", NUMBER_COLUMN},
+                                                              {"Loss", NUMBER_COLUMN}});
+    if (file == nullptr) return;
+    for (const SensitivityEntry &e : entries) {
+        file->add(e.type).add(e.element).add(e.capacity).add(e.flow).add(e.delta).add(e.gain).add(-e.loss).endRow();
+    }
+    file->close();
+}
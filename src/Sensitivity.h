@@ -0,0 +1,96 @@
+#ifndef DA2324_PRJ1_G13_4_SENSITIVITY_H
+#define DA2324_PRJ1_G13_4_SENSITIVITY_H
+
+#include "ScenarioEngine.h"
+
+/**
+ * @brief Effect of changing the capacity of one element of the network on the max flow
+ */
+class SensitivityEntry {
+public:
+    /**
+     * @brief "Pipe", "Reservoir" or "City"
+     */
+    string type;
+
+    /**
+     * @brief Pipe "A->B", or code of the reservoir or city
+     */
+    string element;
+
+    /**
+     * @brief Arcs of the element (both directions for bidirectional pipes)
+     */
+    vector<FlowId> arcs;
+
+    /**
+     * @brief Capacity (pipe capacity, max delivery or demand)
+     */
+    double capacity = 0;
+
+    /**
+     * @brief Water going through the element in the baseline max flow
+     */
+    double flow = 0;
+
+    /**
+     * @brief Capacity change analysed
+     */
+    double delta = 0;
+
+    /**
+     * @brief Max flow gained by adding delta to the capacity
+     */
+    double gain = 0;
+
+    /**
+     * @brief Max flow lost by removing delta from the capacity
+     */
+    double loss = 0;
+};
+
+/**
+ * @brief Marginal value of the capacity of every pipe, reservoir and city.
+ *
+ * Most of it comes from the baseline residual network without solving anything. Raising arc u -> v can only help if u
+ * is reachable from the source and v reaches the sink (the arc crosses every minimum cut), and then +1 gains exactly 1
+ * with integer capacities. Lowering an arc that carries no more than the new capacity loses nothing. Only the remaining
+ * changes are re-solved, in parallel and warm-started from the baseline.
+ */
+class Sensitivity {
+public:
+    /**
+     * @brief Computes the gain and loss of +-delta for every element, delta being 1 or a percentage of its capacity
+     *
+     * Complexity: O(V + E + k V E^2 / threads), k = changes that have to be re-solved
+     *
+     * @param baseline : Solved network
+     * @param percent : Percentage of the capacity to add and remove (0 for 1 unit)
+     * @param solves : Number of changes that had to be re-solved (output)
+     * @return One entry per pipe, reservoir and city
+     */
+    static vector<SensitivityEntry> analyse(const FlowNetwork &baseline, double percent, int &solves);
+
+    /**
+     * @brief Writes the entries to a result file
+     *
+     * Complexity: O(n)
+     *
+     * @param path : Output file, without extension
+     * @param entries : Analysed entries
+     */
+    static void writeReport(const string &path, const vector<SensitivityEntry> &entries);
+
+private:
+    /**
+     * @brief Get every pipe (once, even if bidirectional), reservoir and city of a network
+     *
+     * Complexity: O(V + E)
+     *
+     * @param net : Network
+     * @return Entries with type, element, arcs, capacity and flow filled
+     */
+    static vector<SensitivityEntry> listElements(const FlowNetwork &net);
+};
+
+#endif //DA2324_PRJ1_G13_4_SENSITIVITY_H
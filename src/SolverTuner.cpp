@@ -0,0 +1,265 @@
+#include "SolverTuner.h"
+#include "DinicLinkCut.h"
+#include "NetworkReduction.h"
+#include "NetworkRegions.h"
+#include "Pseudoflow.h"
+#include "PushRelabel.h"
+#include "ResultCache.h"
+#include "ResultWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+string SolverTuner::tuningPath = "../outputFiles/solverTuning";
+map<uint64_t, TuningEntry> SolverTuner::entries;
+bool SolverTuner::loaded = false;
+std::mutex SolverTuner::lock;
+
+string SolverTuner::engineName(SolverEngine engine) {
+    switch (engine) {
+        case REGIONAL_ENGINE:
+            return "regional";
+        case REDUCED_ENGINE:
+            return "reduced";
+        case PUSH_RELABEL_ENGINE:
+            return "pushRelabel";
+        case DINIC_LINK_CUT_ENGINE:
+            return "dinicLinkCut";
+        case PSEUDOFLOW_LOWEST_ENGINE:
+            return "pseudoflowLowest";
+        case PSEUDOFLOW_HIGHEST_ENGINE:
+            return "pseudoflowHighest";
+        default:
+            return "edmondsKarp";
+    }
+}
+
+template <class Cap>
+NetworkFeatures SolverTuner::profile(const BasicFlowNetwork<Cap> &net) {
+    NetworkFeatures f;
+    f.vertices = net.numVertices();
+    f.fingerprint = f.vertices;
+    vector<FlowId> degree(f.vertices, 0);
+    Cap smallest = numeric_limits<Cap>::max();
+    Cap largest = 0;
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        FlowId u = net.getTail(a);
+        FlowId v = net.getHead(a);
+        f.fingerprint = ResultCache::combine(ResultCache::combine(f.fingerprint, u), v);
+        f.arcs++;
+        degree[u]++;
+        degree[v]++;
+        if (u == net.getSource()) f.sources++;
+        if (v == net.getSink()) f.sinks++;
+        if (net.getCapacity(a) > 0) {
+            smallest = min(smallest, net.getCapacity(a));
+            largest = max(largest, net.getCapacity(a));
+        }
+    }
+    if (f.vertices > 0 && f.arcs > 0) {
+        FlowId maxDegree = 0;
+        for (FlowId d : degree) maxDegree = max(maxDegree, d);
+        f.degreeSkew = maxDegree / (2.0 * f.arcs / f.vertices);
+    }
+    if (largest > 0) f.capacityRange = (double) largest / (double) smallest;
+    return f;
+}
+
+template <class Cap>
+Cap SolverTuner::solveWith(BasicFlowNetwork<Cap> &net, SolverEngine engine) {
+    switch (engine) {
+        case REGIONAL_ENGINE:
+            return NetworkRegions(net).solve(net);
+        case REDUCED_ENGINE: {
+            NetworkReduction<Cap> reduction(net);
+            FlowCore<Cap> &reduced = reduction.getReduced();
+            NetworkRegions(reduced).solve(reduced);
+            reduction.expandFlow(net);
+            return net.getFlowValue();
+        }
+        case PUSH_RELABEL_ENGINE:
+            return PushRelabel<Cap>(net).solve();
+        case DINIC_LINK_CUT_ENGINE:
+            return DinicLinkCut<Cap>(net).solve();
+        case PSEUDOFLOW_LOWEST_ENGINE:
+            return Pseudoflow<Cap>(net, LOWEST_LABEL).solve();
+        case PSEUDOFLOW_HIGHEST_ENGINE:
+            return Pseudoflow<Cap>(net, HIGHEST_LABEL).solve();
+        default:
+            return net.maxFlow();
+    }
+}
+
+template <class Cap>
+TuningEntry SolverTuner::calibrate(const BasicFlowNetwork<Cap> &net, const NetworkFeatures &features) {
+    const int REPETITIONS = 3;
+    const double LONG_SOLVE = 1e5;    // microseconds, one run is enough
+
+    TuningEntry entry;
+    entry.features = features;
+    entry.times.assign(ENGINE_COUNT, 0);
+    Cap reference = 0;
+    double best = numeric_limits<double>::infinity();
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        double time = numeric_limits<double>::infinity();
+        Cap value = 0;
+        for (int i = 0; i < REPETITIONS; i++) {
+            BasicFlowNetwork<Cap> copy = net;
+            auto start = chrono::steady_clock::now();
+            value = solveWith(copy, (SolverEngine) e);
+            time = min(time, chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+            if (time > LONG_SOLVE) break;
+        }
+        entry.times[e] = time;
+
+        if (e == EDMONDS_KARP_ENGINE) reference = value;
+        else if (std::abs((double) value - (double) reference) > 1e-6 * max(1.0, std::abs((double) reference))) {
+            cerr << "Error: the " << engineName((SolverEngine) e) << " engine found a max flow of " << value
+                 << " instead of " << reference << ", it will not be used." << endl;
+            continue;
+        }
+        if (time < best) {
+            best = time;
+            entry.engine = (SolverEngine) e;
+        }
+    }
+    return entry;
+}
+
+template <class Cap>
+TuningEntry SolverTuner::choose(const BasicFlowNetwork<Cap> &net) {
+    NetworkFeatures features = profile(net);
+    std::lock_guard<std::mutex> guard(lock);
+    load();
+    auto it = entries.find(features.fingerprint);
+    if (it != entries.end()) return it->second;
+
+    TuningEntry entry = calibrate(net, features);
+    entries[features.fingerprint] = entry;
+    save();
+    return entry;
+}
+
+template <class Cap>
+Cap SolverTuner::solve(BasicFlowNetwork<Cap> &net) {
+    SolverEngine engine = choose(net).engine;
+    solveWith(net, engine);
+    // the engine was only compared with Edmonds Karp on the calibrated capacities, so each result is checked
+    if (engine != EDMONDS_KARP_ENGINE && net.getSourceSide()[net.getSink()]) {
+        cerr << "Error: the " << engineName(engine) << " engine left an augmenting path, finished with Edmonds Karp." << endl;
+        net.maxFlow();
+    }
+    net.canonicalizeFlows();
+    return net.getFlowValue();
+}
+
+double SolverTuner::solveExact(FlowNetwork &net) {
+    switch (net.getCapacityKind()) {
+        case INT32_CAPACITY: {
+            BasicFlowNetwork<int32_t> exact(net);
+            solve(exact);
+            net = FlowNetwork(exact);
+            break;
+        }
+        case INT64_CAPACITY: {
+            BasicFlowNetwork<int64_t> exact(net);
+            solve(exact);
+            net = FlowNetwork(exact);
+            break;
+        }
+        default:
+            solve(net);
+    }
+    return net.getFlowValue();
+}
+
+void SolverTuner::load() {
+    if (loaded) return;
+    loaded = true;
+    ifstream file(tuningPath + ".csv");
+    if (!file.is_open()) return;    // nothing calibrated yet
+
+    string line;
+    getline(file, line);
+    vector<string> header;
+    stringstream names(line);
+    string name;
+    while (getline(names, name, ',')) header.push_back(name);
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        if (find(header.begin(), header.end(), engineName((SolverEngine) e) + "Us") == header.end()) return;    // new engine, calibrate again
+    }
+
+    while (getline(file, line)) {
+        stringstream s(line);
+        vector<string> values;
+        string value;
+        while (getline(s, value, ',')) values.push_back(value);
+        if (values.size() < 8) continue;
+
+        TuningEntry entry;
+        entry.times.assign(ENGINE_COUNT, 0);
+        bool known = false;
+        try {
+            entry.features.fingerprint = stoull(values[0], nullptr, 16);
+            for (int e = 0; e < ENGINE_COUNT; e++) {
+                if (values[1] == engineName((SolverEngine) e)) {
+                    entry.engine = (SolverEngine) e;
+                    known = true;
+                }
+            }
+            entry.features.vertices = (FlowId) stoul(values[2]);
+            entry.features.arcs = (FlowId) stoul(values[3]);
+            entry.features.degreeSkew = stod(values[4]);
+            entry.features.capacityRange = stod(values[5]);
+            entry.features.sources = (FlowId) stoul(values[6]);
+            entry.features.sinks = (FlowId) stoul(values[7]);
+            for (size_t i = 8; i < values.size() && i < header.size(); i++) {
+                for (int e = 0; e < ENGINE_COUNT; e++) {
+                    if (header[i] == engineName((SolverEngine) e) + "Us") entry.times[e] = stod(values[i]);
+                }
+            }
+        }
+        catch (const exception &) {
+            continue;
+        }
+        if (known) entries[entry.features.fingerprint] = entry;
+    }
+}
+
+void SolverTuner::save() {
+    vector<ResultColumn> columns = {{"Fingerprint", TEXT_COLUMN}, {"Engine", TEXT_COLUMN}, {"Vertices", NUMBER_COLUMN},
+                                    {"Arcs", NUMBER_COLUMN}, {"DegreeSkew", NUMBER_COLUMN}, {"CapacityRange", NUMBER_COLUMN},
+                                    {"Sources", NUMBER_COLUMN}, {"Sinks", NUMBER_COLUMN}};
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        columns.push_back({engineName((SolverEngine) e) + "Us", NUMBER_COLUMN});
+    }
+    unique_ptr<ResultWriter> file = ResultWriter::open(tuningPath, columns, CSV_FORMAT);    // read back by load
+    if (file == nullptr) return;
+    for (auto &it : entries) {
+        const TuningEntry &entry = it.second;
+        char fingerprint[17];
+        snprintf(fingerprint, sizeof(fingerprint), "%016llx", (unsigned long long) it.first);
+        file->add(string(fingerprint)).add(engineName(entry.engine)).add(to_string(entry.features.vertices))
+             .add(to_string(entry.features.arcs)).add(entry.features.degreeSkew).add(entry.features.capacityRange)
+             .add(to_string(entry.features.sources)).add(to_string(entry.features.sinks));
+        for (double t : entry.times) file->add(t);
+        file->endRow();
+    }
+    file->close();
+}
+
+template NetworkFeatures SolverTuner::profile(const BasicFlowNetwork<int32_t> &net);
+template NetworkFeatures SolverTuner::profile(const BasicFlowNetwork<int64_t> &net);
+template NetworkFeatures SolverTuner::profile(const BasicFlowNetwork<double> &net);
+template TuningEntry SolverTuner::choose(const BasicFlowNetwork<int32_t> &net);
+template TuningEntry SolverTuner::choose(const BasicFlowNetwork<int64_t> &net);
+template TuningEntry SolverTuner::choose(const BasicFlowNetwork<double> &net);
+template int32_t SolverTuner::solve(BasicFlowNetwork<int32_t> &net);
+template int64_t SolverTuner::solve(BasicFlowNetwork<int64_t> &net);
+template double SolverTuner::solve(BasicFlowNetwork<double> &net);
+template int32_t SolverTuner::solveWith(BasicFlowNetwork<int32_t> &net, SolverEngine engine);
+template int64_t SolverTuner::solveWith(BasicFlowNetwork<int64_t> &net, SolverEngine engine);
+template double SolverTuner::solveWith(BasicFlowNetwork<double> &net, SolverEngine engine);
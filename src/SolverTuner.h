@@ -0,0 +1,203 @@
+#ifndef DA2324_PRJ1_G13_4_SOLVERTUNER_H
+#define DA2324_PRJ1_G13_4_SOLVERTUNER_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include "FlowNetwork.h"
+
+/**
+ * @brief Max flow engines able to solve a network from scratch
+ */
+enum SolverEngine {
+    EDMONDS_KARP_ENGINE,           // FlowCore::maxFlow on the whole network
+    REGIONAL_ENGINE,               // Edmonds Karp per region, in parallel (NetworkRegions)
+    REDUCED_ENGINE,                // the above on the reduced network (NetworkReduction)
+    PUSH_RELABEL_ENGINE,           // parallel push-relabel on the whole network (PushRelabel)
+    DINIC_LINK_CUT_ENGINE,         // Dinic with link-cut trees on the whole network (DinicLinkCut)
+    PSEUDOFLOW_LOWEST_ENGINE,      // Hochbaum's pseudoflow, lowest label first (Pseudoflow)
+    PSEUDOFLOW_HIGHEST_ENGINE,     // Hochbaum's pseudoflow, highest label first (Pseudoflow)
+    ENGINE_COUNT
+};
+
+/**
+ * @brief Features of a network that decide which engine is the fastest
+ */
+class NetworkFeatures {
+public:
+    /**
+     * @brief Hash of the topology (vertices and arc end points, not capacities), so that the variants analysed by
+     * removing or changing elements share it
+     */
+    uint64_t fingerprint = 0;
+
+    /**
+     * @brief Number of vertices
+     */
+    FlowId vertices = 0;
+
+    /**
+     * @brief Number of arcs, without residual twins
+     */
+    FlowId arcs = 0;
+
+    /**
+     * @brief Largest degree over average degree
+     */
+    double degreeSkew = 0;
+
+    /**
+     * @brief Largest over smallest positive capacity
+     */
+    double capacityRange = 0;
+
+    /**
+     * @brief Arcs leaving the source (reservoirs)
+     */
+    FlowId sources = 0;
+
+    /**
+     * @brief Arcs entering the sink (cities)
+     */
+    FlowId sinks = 0;
+};
+
+/**
+ * @brief Result of the calibration of a network
+ */
+class TuningEntry {
+public:
+    /**
+     * @brief Network calibrated
+     */
+    NetworkFeatures features;
+
+    /**
+     * @brief Fastest engine
+     */
+    SolverEngine engine = EDMONDS_KARP_ENGINE;
+
+    /**
+     * @brief Time of each engine, in microseconds (0 if not calibrated in this run)
+     */
+    vector<double> times;
+};
+
+/**
+ * @brief Chooses the engine used by every from-scratch max flow (AuxFunctions::MaxFlow and ResultCache::solvedNetwork).
+ *
+ * The first time a network is solved, every engine solves it a few times and the fastest one (among those that agree on
+ * the max flow value) wins. Winners are kept by fingerprint in memory and in outputFiles/solverTuning.csv, so the
+ * calibration only runs once per dataset.
+ */
+class SolverTuner {
+public:
+    /**
+     * @brief File where the winners are kept
+     */
+    static string tuningPath;
+
+    /**
+     * @brief Get the features of a network
+     *
+     * Complexity: O(V + E)
+     *
+     * @param net : Network
+     * @return Features
+     */
+    template <class Cap>
+    static NetworkFeatures profile(const BasicFlowNetwork<Cap> &net);
+
+    /**
+     * @brief Get the engine for a network, calibrating it the first time its fingerprint is seen
+     *
+     * Complexity: O(V + E) once known, otherwise the time of solving it a few times with every engine
+     *
+     * @param net : Network, with no flow
+     * @return Entry of the network
+     */
+    template <class Cap>
+    static TuningEntry choose(const BasicFlowNetwork<Cap> &net);
+
+    /**
+     * @brief Solves a network with the engine chosen for it. The result is checked for an augmenting path (finished with
+     * Edmonds Karp if one is left) and then made canonical (FlowCore::canonicalizeFlows), so the flows reported, and
+     * every analysis started from them, do not depend on which engine won. That holds for Edmonds Karp as well: the
+     * flow of each pipe is then the one of the max flow with the least water in the pipes (never more than the engine
+     * sent), with no water going both ways along a pipe, and the split among the cities is the canonical one of that
+     * flow rather than the one the engine happened to find.
+     *
+     * Complexity: that of the engine, plus O((k + C + r) V E) to make the flow canonical (see
+     * FlowCore::canonicalizeFlows)
+     *
+     * @param net : Network, with no flow
+     * @return Max flow
+     */
+    template <class Cap>
+    static Cap solve(BasicFlowNetwork<Cap> &net);
+
+    /**
+     * @brief Solves a network with the engine chosen for it, in the narrowest capacity type that represents it exactly
+     *
+     * Complexity: that of the engine, plus O(V + E) for the conversions
+     *
+     * @param net : Network, with no flow
+     * @return Max flow
+     */
+    static double solveExact(FlowNetwork &net);
+
+    /**
+     * @brief Solves a network with a given engine
+     *
+     * Complexity: that of the engine
+     *
+     * @param net : Network, with no flow
+     * @param engine : Engine
+     * @return Max flow
+     */
+    template <class Cap>
+    static Cap solveWith(BasicFlowNetwork<Cap> &net, SolverEngine engine);
+
+    /**
+     * @brief Get the name of an engine
+     *
+     * Complexity: O(1)
+     *
+     * @param engine : Engine
+     * @return Name
+     */
+    static string engineName(SolverEngine engine);
+
+private:
+    static map<uint64_t, TuningEntry> entries;
+    static bool loaded;
+    static std::mutex lock;
+
+    /**
+     * @brief Reads the winners saved by previous runs (once)
+     *
+     * Complexity: O(n log n)
+     */
+    static void load();
+
+    /**
+     * @brief Writes every known winner to tuningPath
+     *
+     * Complexity: O(n)
+     */
+    static void save();
+
+    /**
+     * @brief Times every engine on a network
+     *
+     * Complexity: O(repetitions * engines * solve)
+     *
+     * @param net : Network, with no flow
+     * @param features : Its features
+     * @return Entry with the winner
+     */
+    template <class Cap>
+    static TuningEntry calibrate(const BasicFlowNetwork<Cap> &net, const NetworkFeatures &features);
+};
+
+#endif //DA2324_PRJ1_G13_4_SOLVERTUNER_H
@@ -1,15 +1,48 @@
 #include "Station.h"
-#include <utility>
 
-Station::Station(int i, string c) {
-    Id = i;
-    code = std::move(c);
+Station::Station(const StationTable *t, size_t r) {
+    table = t;
+    row = r;
 }
 
 int Station::getId() const {
-    return Id;
+    return table->ids[row];
 }
 
-string Station::getCode() {
-    return code;
+const string &Station::getCode() const {
+    return table->pool->get(table->codes[row]);
+}
+
+StationTable::StationTable(StringPool &p) {
+    pool = &p;
+}
+
+void StationTable::add(int i, const string &c) {
+    ids.push_back(i);
+    codes.push_back(pool->intern(c));
+}
+
+void StationTable::clear() {
+    ids.clear();
+    codes.clear();
+}
+
+size_t StationTable::size() const {
+    return ids.size();
+}
+
+bool StationTable::empty() const {
+    return ids.empty();
+}
+
+Station StationTable::operator[](size_t i) const {
+    return Station(this, i);
+}
+
+StationTable::iterator StationTable::begin() const {
+    return iterator(this, 0);
+}
+
+StationTable::iterator StationTable::end() const {
+    return iterator(this, size());
 }
@@ -2,23 +2,28 @@
 #define DA2324_PRJ1_G13_4_STATION_H
 
 #include <string>
+#include <vector>
+#include "EntityIterator.h"
+#include "StringPool.h"
 using namespace std;
 
+class StationTable;
+
 /**
- * @brief Represents a Station
+ * @brief Represents a Station (a view of one row of a StationTable, cheap to copy)
  */
 class Station {
 private:
-    int Id;
-    string code;
+    const StationTable *table;
+    size_t row;
 public:
     /**
      * @brief Constructor of the Station class
      *
-     * @param i : Id
-     * @param c : Code
+     * @param t : Table of the Station
+     * @param r : Row of the Station in the table
      */
-    Station(int i, string c);
+    Station(const StationTable *t, size_t r);
 
     /**
      * @brief Get the Id of the Station
@@ -36,7 +41,77 @@ public:
      *
      * @return Returns the value of the Station's code
      */
-    string getCode();
+    const string &getCode() const;
+};
+
+/**
+ * @brief All the stations, one column per field, with codes interned in a StringPool.
+ */
+class StationTable {
+public:
+    typedef EntityIterator<StationTable, Station> iterator;
+
+    /**
+     * @brief Constructor of the StationTable class
+     *
+     * @param p : Pool of the codes (must outlive the table)
+     */
+    explicit StationTable(StringPool &p);
+
+    /**
+     * @brief Adds a Station at the end of the table
+     *
+     * Complexity: O(|c|) amortized
+     *
+     * @param i : Id
+     * @param c : Code
+     */
+    void add(int i, const string &c);
+
+    /**
+     * @brief Removes every Station (the interned strings stay in the pool)
+     *
+     * Complexity: O(1)
+     */
+    void clear();
+
+    /**
+     * @brief Get number of stations
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of stations
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check if there are no stations
+     *
+     * Complexity: O(1)
+     *
+     * @return True or false
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get a Station by its row
+     *
+     * Complexity: O(1)
+     *
+     * @param i : Row
+     * @return Station
+     */
+    Station operator[](size_t i) const;
+
+    iterator begin() const;
+    iterator end() const;
+
+private:
+    friend class Station;
+
+    StringPool *pool;
+    vector<int> ids;
+    vector<StringId> codes;
 };
 
 
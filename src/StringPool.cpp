@@ -0,0 +1,18 @@
+#include "StringPool.h"
+
+StringId StringPool::intern(const string &s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) return it->second;
+    StringId id = (StringId) strings.size();
+    strings.push_back(s);
+    ids.emplace(s, id);
+    return id;
+}
+
+const string &StringPool::get(StringId id) const {
+    return strings[id];
+}
+
+size_t StringPool::size() const {
+    return strings.size();
+}
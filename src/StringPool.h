@@ -0,0 +1,56 @@
+#ifndef DA2324_PRJ1_G13_4_STRINGPOOL_H
+#define DA2324_PRJ1_G13_4_STRINGPOOL_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+/**
+ * @brief Handle of an interned string
+ */
+typedef uint32_t StringId;
+
+/**
+ * @brief Interned strings, each stored once and referred to by a 32-bit handle.
+ *
+ * Strings are only ever added, so handles and the references returned by get stay valid while the pool lives.
+ */
+class StringPool {
+public:
+    /**
+     * @brief Get the handle of a string, adding it to the pool if it is new
+     *
+     * Complexity: O(|s|) expected
+     *
+     * @param s : String
+     * @return Handle
+     */
+    StringId intern(const string &s);
+
+    /**
+     * @brief Get the string of a handle
+     *
+     * Complexity: O(1)
+     *
+     * @param id : Handle returned by intern
+     * @return String
+     */
+    const string &get(StringId id) const;
+
+    /**
+     * @brief Get number of distinct strings
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of strings
+     */
+    size_t size() const;
+
+private:
+    deque<string> strings;                      // by handle (a deque never moves its elements)
+    unordered_map<string, StringId> ids;
+};
+
+#endif //DA2324_PRJ1_G13_4_STRINGPOOL_H
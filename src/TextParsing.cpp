@@ -0,0 +1,29 @@
+#include "TextParsing.h"
+#include <cmath>
+#include <stdexcept>
+
+string TextParsing::trim(const string &s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+bool TextParsing::parseNumber(const string &value, double &number, string &error) {
+    string text = trim(value);
+    if (text.empty()) {
+        error = "missing value";
+        return false;
+    }
+    try {
+        size_t used;
+        double read = stod(text, &used);
+        if (used != text.size() || !isfinite(read)) throw invalid_argument(text);
+        number = read;
+    }
+    catch (const exception &) {
+        error = "invalid value '" + text + "'";
+        return false;
+    }
+    return true;
+}
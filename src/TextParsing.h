@@ -0,0 +1,35 @@
+#ifndef DA2324_PRJ1_G13_4_TEXTPARSING_H
+#define DA2324_PRJ1_G13_4_TEXTPARSING_H
+
+#include <string>
+using namespace std;
+
+/**
+ * @brief Helpers shared by the readers of the input files (scenarios, edits, simulation and planner inputs)
+ */
+class TextParsing {
+public:
+    /**
+     * @brief Removes spaces, tabs and line breaks at both ends of a string
+     *
+     * Complexity: O(n)
+     *
+     * @param s : String
+     * @return Trimmed string
+     */
+    static string trim(const string &s);
+
+    /**
+     * @brief Reads a finite number that must take the whole value (spaces around it are ignored)
+     *
+     * Complexity: O(n)
+     *
+     * @param value : Text of the value
+     * @param number : Number read (output)
+     * @param error : Reason, if the value is not a finite number (output)
+     * @return True if the value is a finite number
+     */
+    static bool parseNumber(const string &value, double &number, string &error);
+};
+
+#endif //DA2324_PRJ1_G13_4_TEXTPARSING_H
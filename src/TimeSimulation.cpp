@@ -0,0 +1,229 @@
+#include "TimeSimulation.h"
+#include "csvInfo.h"
+#include "ResultCache.h"
+#include "ResultWriter.h"
+#include "TextParsing.h"
+
+bool TimeSimulation::readDemandProfiles(const string &path, vector<vector<double>> &profiles) {
+    profiles.assign(csvInfo::citiesVector.size(), vector<double>());
+    fstream file;
+    file.open(path);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open the file." << endl;
+        return false;
+    }
+
+    map<string, vector<double>> read;
+    string line;
+    string code;
+    string factor;
+    string error;
+    int n = 1;
+    getline(file, line);    // discard header line
+    while (getline(file, line)) {
+        n++;
+        stringstream s(line);
+        getline(s, code, ',');
+        vector<double> factors;
+        bool valid = true;
+        while (valid && getline(s, factor, ',')) {
+            double f;
+            if (TextParsing::trim(factor).empty()) continue;
+            if (!TextParsing::parseNumber(factor, f, error)) valid = false;
+            else if (f < 0) {
+                error = "negative demand factor";
+                valid = false;
+            }
+            else factors.push_back(f);
+        }
+        if (!valid) {
+            cerr << "Error: line " << n << ": " << error << endl;
+            continue;
+        }
+        if (!factors.empty()) read[code] = factors;
+    }
+    file.close();
+
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        auto it = read.find(csvInfo::citiesVector[i].getCode());
+        if (it == read.end()) it = read.find("*");
+        if (it != read.end()) profiles[i] = it->second;
+    }
+    return true;
+}
+
+bool TimeSimulation::readStorage(const string &path, vector<ReservoirStorage> &storage) {
+    storage.assign(csvInfo::reservoirsVector.size(), ReservoirStorage());
+    fstream file;
+    file.open(path);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open the file." << endl;
+        return false;
+    }
+
+    string line;
+    string code;
+    string capacity;
+    string level;
+    string inflow;
+    string error;
+    int n = 1;
+    getline(file, line);    // discard header line
+    while (getline(file, line)) {
+        n++;
+        stringstream s(line);
+        getline(s, code, ',');
+        getline(s, capacity, ',');
+        getline(s, level, ',');
+        getline(s, inflow);
+
+        Vertex* v = csvInfo::pipesGraph.findVertex(code);
+        if (v == nullptr || v->getType() != 1) {
+            cerr << "Error: line " << n << ": unknown reservoir '" << code << "'" << endl;
+            continue;
+        }
+        double c, l, i;
+        if (!TextParsing::parseNumber(capacity, c, error) || !TextParsing::parseNumber(level, l, error)
+            || !TextParsing::parseNumber(inflow, i, error)) {
+            cerr << "Error: line " << n << ": " << error << endl;
+            continue;
+        }
+        if (c < 0 || l < 0 || i < 0) {
+            string field = c < 0 ? "capacity" : l < 0 ? "initial level" : "inflow";
+            cerr << "Error: line " << n << ": negative " << field << endl;
+            continue;
+        }
+        ReservoirStorage &r = storage[v->getPos()];
+        r.limited = true;
+        r.capacity = c;
+        r.level = min(l, r.capacity);
+        r.inflow = i;
+    }
+    file.close();
+    return true;
+}
+
+double TimeSimulation::getAvailable(const ReservoirStorage &storage, double maxDelivery) {
+    if (!storage.limited) return maxDelivery;
+    return min(maxDelivery, storage.level + storage.inflow);
+}
+
+SimulationSummary TimeSimulation::run(const vector<vector<double>> &profiles, vector<ReservoirStorage> storage, long long periods,
+                                      const string &citiesPath, const string &reservoirsPath) {
+    SimulationSummary summary;
+    FlowNetwork net(*ResultCache::solvedNetwork());
+
+    unique_ptr<ResultWriter> cities = ResultWriter::open(citiesPath, {{"Period", NUMBER_COLUMN}, {"CityCode", TEXT_COLUMN},
+                                                                      {"Demand", NUMBER_COLUMN}, {"Water", NUMBER_COLUMN},
+                                                                      {"Deficit", NUMBER_COLUMN}});
+    unique_ptr<ResultWriter> reservoirs = ResultWriter::open(reservoirsPath, {{"Period", NUMBER_COLUMN},
+                                                                              {"ReservoirCode", TEXT_COLUMN},
+                                                                              {"Delivered", NUMBER_COLUMN},
+                                                                              {"Level", NUMBER_COLUMN}});
+    if (cities == nullptr || reservoirs == nullptr) return summary;
+
+    const vector<int> &maxDeliveries = csvInfo::reservoirsVector.getMaxDeliveries();
+    const vector<double> &demands = csvInfo::citiesVector.getDemands();
+    for (long long t = 0; t < periods; t++) {
+        for (int r = 0; r < (int) maxDeliveries.size(); r++) {
+            net.setCapacity(net.getReservoirArc(r), getAvailable(storage[r], maxDeliveries[r]));
+        }
+        for (int c = 0; c < (int) demands.size(); c++) {
+            double demand = demands[c];
+            if (!profiles[c].empty()) demand *= profiles[c][t % profiles[c].size()];
+            net.setCapacity(net.getCityArc(c), demand);
+        }
+        net.maxFlow();
+
+        writeCities(net, to_string(t), *cities, summary);
+
+        for (int r = 0; r < (int) csvInfo::reservoirsVector.size(); r++) {
+            double delivered = net.getFlow(net.getReservoirArc(r));
+            ReservoirStorage &s = storage[r];
+            if (s.limited) s.level = min(s.capacity, max(0.0, s.level + s.inflow - delivered));
+            reservoirs->add((double) t).add(csvInfo::reservoirsVector[r].getCode()).add(delivered);
+            if (s.limited) reservoirs->add(s.level);
+            reservoirs->endRow();
+        }
+    }
+    cities->close();
+    reservoirs->close();
+    return summary;
+}
+
+void TimeSimulation::writeCities(const FlowNetwork &net, const string &period, ResultWriter &file, SimulationSummary &summary) {
+    bool deficit = false;
+    for (int c = 0; c < (int) csvInfo::citiesVector.size(); c++) {
+        double demand = net.getCapacity(net.getCityArc(c));
+        double water = net.getFlow(net.getCityArc(c));
+        double missing = water < demand - 1e-9 ? demand - water : 0;
+        summary.demand += demand;
+        summary.delivered += water;
+        if (missing > 0) deficit = true;
+        file.add(period).add(csvInfo::citiesVector[c].getCode()).add(demand).add(water).add(-missing).endRow();
+    }
+    if (deficit) summary.periodsInDeficit++;
+    summary.periods++;
+}
+
+SimulationSummary TimeSimulation::replayDemands(const string &seriesPath, const string &outPath) {
+    SimulationSummary summary;
+    fstream series;
+    series.open(seriesPath);
+    if (!series.is_open()) {
+        cerr << "Error: Unable to open the file." << endl;
+        return summary;
+    }
+
+    FlowNetwork net(*ResultCache::solvedNetwork());
+    unique_ptr<ResultWriter> file = ResultWriter::open(outPath, {{"Timestamp", TEXT_COLUMN}, {"CityCode", TEXT_COLUMN},
+                                                                 {"Demand", NUMBER_COLUMN}, {"Water", NUMBER_COLUMN},
+                                                                 {"Deficit", NUMBER_COLUMN}});
+    if (file == nullptr) return summary;
+
+    string line;
+    string code;
+    string timestamp;
+    string demand;
+    string current;
+    string error;
+    bool pending = false;
+    long long n = 1;
+    getline(series, line);    // discard header line
+    while (getline(series, line)) {
+        n++;
+        stringstream s(line);
+        getline(s, code, ',');
+        getline(s, timestamp, ',');
+        getline(s, demand);
+        if (code.empty()) continue;
+        double value = 0;
+        if (!TextParsing::parseNumber(demand, value, error) || value < 0) {
+            if (value < 0) error = "negative demand";
+            cerr << "Error: line " << n << ": " << error << endl;
+            continue;
+        }
+
+        if (pending && timestamp != current) {
+            net.maxFlow();
+            writeCities(net, current, *file, summary);
+        }
+        current = timestamp;
+        pending = true;
+
+        Vertex* v = csvInfo::pipesGraph.findVertex(code);
+        if (v == nullptr || v->getType() != 0) {
+            cerr << "Error: line " << n << ": unknown city '" << code << "'" << endl;
+            continue;
+        }
+        FlowId arc = net.getCityArc(v->getPos());
+        if (value != net.getCapacity(arc)) net.setCapacity(arc, value);
+    }
+    if (pending) {
+        net.maxFlow();
+        writeCities(net, current, *file, summary);
+    }
+    series.close();
+    file->close();
+    return summary;
+}
@@ -0,0 +1,152 @@
+#ifndef DA2324_PRJ1_G13_4_TIMESIMULATION_H
+#define DA2324_PRJ1_G13_4_TIMESIMULATION_H
+
+#include "FlowNetwork.h"
+#include "ResultWriter.h"
+
+/**
+ * @brief Storage of a reservoir over a simulation. Volumes are in units of max delivery per period.
+ */
+class ReservoirStorage {
+public:
+    /**
+     * @brief Whether the reservoir has limited storage (otherwise it always delivers up to its max delivery)
+     */
+    bool limited = false;
+
+    /**
+     * @brief Maximum volume stored
+     */
+    double capacity = 0;
+
+    /**
+     * @brief Volume stored
+     */
+    double level = 0;
+
+    /**
+     * @brief Volume flowing into the reservoir each period
+     */
+    double inflow = 0;
+};
+
+/**
+ * @brief Totals of a simulation
+ */
+class SimulationSummary {
+public:
+    /**
+     * @brief Number of periods simulated
+     */
+    long long periods = 0;
+
+    /**
+     * @brief Total demand of all cities over all periods
+     */
+    double demand = 0;
+
+    /**
+     * @brief Total water delivered over all periods
+     */
+    double delivered = 0;
+
+    /**
+     * @brief Number of periods in which some city got less than its demand
+     */
+    long long periodsInDeficit = 0;
+};
+
+/**
+ * @brief Simulation of the network over a horizon of periods, with city demand profiles and reservoirs whose storage
+ * depletes and refills.
+ *
+ * Myopic, period by period: each period delivers its own max flow with the water its reservoirs have at that moment,
+ * without looking ahead. This is a heuristic, not an optimum over the horizon: which reservoirs a period's max flow
+ * drains changes what later periods can deliver, so the totals can be below the best schedule. Each period only changes
+ * the super source arcs (water available) and super sink arcs (demand), and is re-solved from the flow of the previous
+ * period. Results are written as each period is solved, so memory does not grow with the horizon.
+ */
+class TimeSimulation {
+public:
+    /**
+     * @brief Reads demand profiles, "CityCode,Factor1,Factor2,...". The demand of a city in period t is its demand times
+     * factor (t mod number of factors). The code "*" sets the profile of cities without one; without it they are flat.
+     * Lines with a factor that is not a number, or is negative, are reported and skipped.
+     *
+     * Complexity: O(n)
+     *
+     * @param path : Profile file
+     * @param profiles : Factors of each city, indexed like citiesVector (output)
+     * @return True if the file could be read
+     */
+    static bool readDemandProfiles(const string &path, vector<vector<double>> &profiles);
+
+    /**
+     * @brief Reads reservoir storage, "ReservoirCode,Capacity,InitialLevel,Inflow". Reservoirs not in the file are not
+     * limited by storage. Lines with a value that is not a number, or is negative, are reported and skipped.
+     *
+     * Complexity: O(n)
+     *
+     * @param path : Storage file
+     * @param storage : Storage of each reservoir, indexed like reservoirsVector (output)
+     * @return True if the file could be read
+     */
+    static bool readStorage(const string &path, vector<ReservoirStorage> &storage);
+
+    /**
+     * @brief Get the water a reservoir can deliver in a period
+     *
+     * Complexity: O(1)
+     *
+     * @param storage : Storage of the reservoir
+     * @param maxDelivery : Max delivery of the reservoir
+     * @return Water available
+     */
+    static double getAvailable(const ReservoirStorage &storage, double maxDelivery);
+
+    /**
+     * @brief Simulates a number of periods, writing per-period results of cities ("Period,CityCode,Demand,Water,Deficit")
+     * and reservoirs ("Period,ReservoirCode,Delivered,Level") as they are computed
+     *
+     * Complexity: O(T * V E^2) in the worst case, usually a few augmenting paths per period
+     *
+     * @param profiles : Demand factors of each city
+     * @param storage : Storage of each reservoir at the start
+     * @param periods : Number of periods
+     * @param citiesPath : Output file for cities, without extension
+     * @param reservoirsPath : Output file for reservoirs, without extension
+     * @return Totals
+     */
+    static SimulationSummary run(const vector<vector<double>> &profiles, vector<ReservoirStorage> storage, long long periods,
+                                 const string &citiesPath, const string &reservoirsPath);
+
+    /**
+     * @brief Replays a demand time series, "CityCode,Timestamp,Demand" sorted by timestamp, one reading per line. The
+     * readings of each timestamp update only the super sink arcs of their cities (the others keep their last demand, at
+     * first the one of Cities.csv) and the max flow is re-solved from the flow of the previous timestamp. The file is read
+     * one line at a time and the water of every city is written per timestamp ("Timestamp,CityCode,Demand,Water,Deficit").
+     * Readings with an unknown city or a missing, malformed or negative demand are reported with their line and skipped.
+     *
+     * Complexity: O(n + T V E^2) in the worst case, usually a few augmenting paths per timestamp
+     *
+     * @param seriesPath : Demand time series
+     * @param outPath : Output file, without extension
+     * @return Totals, with a period per timestamp
+     */
+    static SimulationSummary replayDemands(const string &seriesPath, const string &outPath);
+
+private:
+    /**
+     * @brief Writes demand, water and deficit of every city in a solved network and adds them to the totals
+     *
+     * Complexity: O(C)
+     *
+     * @param net : Solved network
+     * @param period : Period label
+     * @param file : Output file
+     * @param summary : Totals (updated)
+     */
+    static void writeCities(const FlowNetwork &net, const string &period, ResultWriter &file, SimulationSummary &summary);
+};
+
+#endif //DA2324_PRJ1_G13_4_TIMESIMULATION_H
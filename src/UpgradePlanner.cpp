@@ -0,0 +1,122 @@
+#include "UpgradePlanner.h"
+#include "TextParsing.h"
+#include <fstream>
+#include <sstream>
+
+vector<UpgradeOption> UpgradePlanner::readOptions(const string &path, const FlowNetwork &net) {
+    vector<UpgradeOption> options;
+    fstream file;
+    file.open(path);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open the file." << endl;
+        return options;
+    }
+
+    string line;
+    string cost;
+    string increase;
+    string error;
+    int n = 1;
+    getline(file, line);    // discard header line
+    while (getline(file, line)) {
+        n++;
+        stringstream s(line);
+        UpgradeOption o;
+        getline(s, o.pointA, ',');
+        getline(s, o.pointB, ',');
+        getline(s, cost, ',');
+        getline(s, increase);
+        if (o.pointA.empty()) continue;
+
+        FlowId a = net.findVertex(o.pointA);
+        FlowId b = net.findVertex(o.pointB);
+        if (a != NO_ID && b != NO_ID) o.arcs = net.findPipeArcs(a, b);
+        if (o.arcs.empty()) {
+            cerr << "Error: line " << n << ": unknown pipe '" << o.pointA << "->" << o.pointB << "'" << endl;
+            continue;
+        }
+        if (!TextParsing::parseNumber(cost, o.cost, error) || !TextParsing::parseNumber(increase, o.increase, error)) {
+            cerr << "Error: line " << n << ": " << error << endl;
+            continue;
+        }
+        // the plan ranks upgrades by gain per cost
+        if (o.cost <= 0) {
+            cerr << "Error: line " << n << ": the cost of an upgrade must be positive" << endl;
+            continue;
+        }
+        if (o.increase < 0) {
+            cerr << "Error: line " << n << ": the increase of an upgrade can not be negative" << endl;
+            continue;
+        }
+        options.push_back(o);
+    }
+    file.close();
+    return options;
+}
+
+bool UpgradePlanner::crossesMinCut(const UpgradeOption &option, const FlowNetwork &net, const vector<bool> &sourceSide,
+                                   const vector<bool> &sinkSide) {
+    for (FlowId a : option.arcs) {
+        FlowId u = net.getTail(a);
+        FlowId v = net.getHead(a);
+        if ((sourceSide[u] && !sourceSide[v]) || (!sinkSide[u] && sinkSide[v])) return true;
+    }
+    return false;
+}
+
+vector<UpgradeStep> UpgradePlanner::plan(const FlowNetwork &baseline, const vector<UpgradeOption> &options, double budget) {
+    vector<UpgradeStep> steps;
+    FlowNetwork net(baseline);
+    vector<bool> bought(options.size(), false);
+
+    while (true) {
+        vector<bool> sourceSide = net.getSourceSide();
+        vector<bool> sinkSide = net.getSinkSide();
+        int best = -1;
+        double bestGain = 0;
+
+        for (int round = 0; round < 2 && best == -1; round++) {
+            // first the upgrades of min cut pipes, then (if none helps) every affordable upgrade
+            vector<int> candidates;
+            for (int i = 0; i < (int) options.size(); i++) {
+                if (bought[i] || options[i].cost > budget) continue;
+                if (round == 0 && !crossesMinCut(options[i], net, sourceSide, sinkSide)) continue;
+                candidates.push_back(i);
+            }
+            if (candidates.empty()) continue;
+
+            vector<Scenario> scenarios;
+            for (int i : candidates) {
+                Scenario s;
+                s.name = options[i].pointA + "->" + options[i].pointB;
+                for (FlowId a : options[i].arcs) s.changes.emplace_back(a, net.getCapacity(a) + options[i].increase);
+                scenarios.push_back(s);
+            }
+            vector<ScenarioResult> results = ScenarioEngine::evaluateAll(net, scenarios);
+
+            double current = net.getFlowValue();
+            for (int k = 0; k < (int) candidates.size(); k++) {
+                int i = candidates[k];
+                double gain = results[k].maxFlow - current;
+                if (gain <= 1e-9) continue;
+                if (best == -1 || gain / options[i].cost > bestGain / options[best].cost) {
+                    best = i;
+                    bestGain = gain;
+                }
+            }
+        }
+        if (best == -1) break;
+
+        for (FlowId a : options[best].arcs) net.setCapacity(a, net.getCapacity(a) + options[best].increase);
+        net.maxFlow();
+        bought[best] = true;
+        budget -= options[best].cost;
+
+        UpgradeStep step;
+        step.option = best;
+        step.gain = bestGain;
+        step.maxFlow = net.getFlowValue();
+        steps.push_back(step);
+    }
+    return steps;
+}
@@ -0,0 +1,109 @@
+#ifndef DA2324_PRJ1_G13_4_UPGRADEPLANNER_H
+#define DA2324_PRJ1_G13_4_UPGRADEPLANNER_H
+
+#include "ScenarioEngine.h"
+
+/**
+ * @brief Capacity increase that can be bought for a pipe
+ */
+class UpgradeOption {
+public:
+    /**
+     * @brief Origin of the pipe
+     */
+    string pointA;
+
+    /**
+     * @brief Destination of the pipe
+     */
+    string pointB;
+
+    /**
+     * @brief Cost of the upgrade
+     */
+    double cost = 0;
+
+    /**
+     * @brief Capacity added to the pipe
+     */
+    double increase = 0;
+
+    /**
+     * @brief Arcs of the pipe (both directions for bidirectional pipes)
+     */
+    vector<FlowId> arcs;
+};
+
+/**
+ * @brief Upgrade bought by a plan
+ */
+class UpgradeStep {
+public:
+    /**
+     * @brief Index of the option bought
+     */
+    int option = 0;
+
+    /**
+     * @brief Water gained by the upgrade
+     */
+    double gain = 0;
+
+    /**
+     * @brief Max flow after the upgrade
+     */
+    double maxFlow = 0;
+};
+
+/**
+ * @brief Chooses pipe upgrades within a budget that increase the water delivered.
+ *
+ * Only pipes crossing a minimum cut can increase the max flow on their own, so each round evaluates the affordable
+ * upgrades of min cut pipes (of the cuts closest to the source and to the sink) and buys the one with the largest gain
+ * per cost. Candidates are evaluated as scenarios warm-started from the current residual network, so each one only
+ * augments the extra water its upgrade lets through. When no single min cut upgrade helps (every cut has several
+ * saturated pipes), all affordable upgrades are evaluated before giving up.
+ */
+class UpgradePlanner {
+public:
+    /**
+     * @brief Reads upgrade options, "PointA,PointB,Cost,Increase". Lines with an unknown pipe, a missing or malformed
+     * number, a cost that is not positive or a negative increase are reported with their line and skipped.
+     *
+     * Complexity: O(n)
+     *
+     * @param path : Options file
+     * @param net : Network whose pipes the options refer to
+     * @return Options of existing pipes
+     */
+    static vector<UpgradeOption> readOptions(const string &path, const FlowNetwork &net);
+
+    /**
+     * @brief Greedily buys upgrades within the budget, by gain per cost
+     *
+     * Complexity: O(k n V E^2 / threads) in the worst case, k = upgrades bought, n = candidates per round
+     *
+     * @param baseline : Solved network
+     * @param options : Upgrade options, with positive costs
+     * @param budget : Money available
+     * @return Upgrades bought, in order
+     */
+    static vector<UpgradeStep> plan(const FlowNetwork &baseline, const vector<UpgradeOption> &options, double budget);
+
+private:
+    /**
+     * @brief Checks if an option upgrades a pipe crossing a minimum cut
+     *
+     * Complexity: O(1) per arc
+     *
+     * @param option : Upgrade option
+     * @param net : Network
+     * @param sourceSide : Source side of the cut closest to the source
+     * @param sinkSide : Sink side of the cut closest to the sink
+     * @return True or false
+     */
+    static bool crossesMinCut(const UpgradeOption &option, const FlowNetwork &net, const vector<bool> &sourceSide,
+                              const vector<bool> &sinkSide);
+};
+
+#endif //DA2324_PRJ1_G13_4_UPGRADEPLANNER_H
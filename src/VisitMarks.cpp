@@ -0,0 +1,18 @@
+#include "VisitMarks.h"
+#include <algorithm>
+
+void VisitMarks::reset(size_t n) {
+    if (stamps.size() < n) stamps.resize(n, 0);
+    if (++epoch == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        epoch = 1;
+    }
+}
+
+bool VisitMarks::isVisited(size_t i) const {
+    return stamps[i] == epoch;
+}
+
+void VisitMarks::visit(size_t i) {
+    stamps[i] = epoch;
+}
@@ -0,0 +1,48 @@
+#ifndef DA2324_PRJ1_G13_4_VISITMARKS_H
+#define DA2324_PRJ1_G13_4_VISITMARKS_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+/**
+ * @brief Visited flags of a search, cleared in O(1) by moving to a new epoch instead of resetting every flag.
+ *
+ * Each search owns its marks, so several searches can run at the same time over the same vertices.
+ */
+class VisitMarks {
+public:
+    /**
+     * @brief Starts a new search, with every index unvisited
+     *
+     * Complexity: O(1) amortized (O(n) when the size grows or the epoch counter wraps around)
+     *
+     * @param n : Number of indices
+     */
+    void reset(size_t n);
+
+    /**
+     * @brief Check if an index was visited in the current search
+     *
+     * Complexity: O(1)
+     *
+     * @param i : Index
+     * @return True or false
+     */
+    bool isVisited(size_t i) const;
+
+    /**
+     * @brief Marks an index as visited in the current search
+     *
+     * Complexity: O(1)
+     *
+     * @param i : Index
+     */
+    void visit(size_t i);
+
+private:
+    vector<unsigned> stamps;    // epoch in which each index was last visited
+    unsigned epoch = 0;
+};
+
+#endif //DA2324_PRJ1_G13_4_VISITMARKS_H
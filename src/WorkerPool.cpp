@@ -0,0 +1,72 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threads): nextIndex(0) {
+    if (threads == 0) threads = max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : workers) {
+        t.join();
+    }
+}
+
+unsigned WorkerPool::size() const {
+    return (unsigned) workers.size() + 1;
+}
+
+void WorkerPool::run(size_t n, const function<void(size_t)> &f) {
+    if (n == 0) return;
+    if (workers.empty() || n == 1) {
+        for (size_t i = 0; i < n; i++) f(i);
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        task = &f;
+        count = n;
+        chunk = max((size_t) 1, min((size_t) 1024, n / (8 * size())));
+        nextIndex = 0;
+        busy = (unsigned) workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    drain();
+
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [this]() { return busy == 0; });
+    task = nullptr;
+}
+
+void WorkerPool::work() {
+    unsigned seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        drain();
+        {
+            lock_guard<mutex> guard(lock);
+            if (--busy == 0) finished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::drain() {
+    for (size_t begin = nextIndex.fetch_add(chunk); begin < count; begin = nextIndex.fetch_add(chunk)) {
+        size_t end = min(count, begin + chunk);
+        for (size_t i = begin; i < end; i++) (*task)(i);
+    }
+}
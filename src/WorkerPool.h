@@ -0,0 +1,88 @@
+#ifndef DA2324_PRJ1_G13_4_WORKERPOOL_H
+#define DA2324_PRJ1_G13_4_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief Threads kept alive between parallel loops, for algorithms that run many short loops one after the other
+ * (starting threads for each of them would cost more than the loops).
+ *
+ * The calling thread works too, and run only returns when every index is done, so consecutive loops are separated by
+ * a barrier.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Starts the threads
+     *
+     * Complexity: O(threads)
+     *
+     * @param threads : Number of threads, the caller included (0 for one per hardware thread)
+     */
+    explicit WorkerPool(unsigned threads = 0);
+
+    /**
+     * @brief Stops the threads
+     *
+     * Complexity: O(threads)
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /**
+     * @brief Get number of threads, the caller included
+     *
+     * Complexity: O(1)
+     *
+     * @return Number of threads
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Calls a task for every index in [0, count), spread over the threads in chunks
+     *
+     * Complexity: O(count / threads) calls of the task
+     *
+     * @param count : Number of indices
+     * @param task : Task, must be safe to call from several threads at the same time
+     */
+    void run(size_t count, const function<void(size_t)> &task);
+
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    const function<void(size_t)> *task = nullptr;
+    size_t count = 0;
+    size_t chunk = 1;
+    atomic<size_t> nextIndex;
+    unsigned busy = 0;
+    unsigned generation = 0;
+    bool stopping = false;
+
+    /**
+     * @brief Loop of each thread: waits for a task and works on it
+     *
+     * Complexity: O(1) per task, plus the calls
+     */
+    void work();
+
+    /**
+     * @brief Takes chunks of the current task until none is left
+     *
+     * Complexity: O(count) calls of the task, shared with the other threads
+     */
+    void drain();
+};
+
+#endif //DA2324_PRJ1_G13_4_WORKERPOOL_H
@@ -1,9 +1,15 @@
+#include <functional>
+#include <iterator>
 #include <map>
+#include <thread>
 #include "csvInfo.h"
+#include "ResultWriter.h"
+#include "WorkerPool.h"
 
-vector<Reservoir> csvInfo::reservoirsVector;
-vector<Station> csvInfo::stationsVector;
-vector<City> csvInfo::citiesVector;
+StringPool csvInfo::strings;
+ReservoirTable csvInfo::reservoirsVector(csvInfo::strings);
+StationTable csvInfo::stationsVector(csvInfo::strings);
+CityTable csvInfo::citiesVector(csvInfo::strings);
 Graph csvInfo::pipesGraph;
 std::set<std::string> csvInfo::reservoirSet;
 std::set<std::string> csvInfo::stationSet;
@@ -12,9 +18,46 @@ std::map<std::string, int> csvInfo::cityMap;
 
 csvInfo::csvInfo() = default;
 
-void csvInfo::createReservoir() {
-    reservoirSet.clear();
-    reservoirsVector.clear();
+/**
+ * @brief Row of the reservoirs file
+ */
+struct ReservoirRow {
+    string reservoir;
+    string municipality;
+    int id;
+    string code;
+    int delivery;
+};
+
+/**
+ * @brief Row of the stations file
+ */
+struct StationRow {
+    int id;
+    string code;
+};
+
+/**
+ * @brief Row of the cities file
+ */
+struct CityRow {
+    string city;
+    int id;
+    string code;
+    double demand;
+    int population;
+};
+
+static const size_t PIPES_CHUNK_BYTES = 1 << 20;    // smallest part of the pipes file given to a thread
+
+/**
+ * @brief Reads the reservoirs file
+ *
+ * Complexity: O(n)
+ *
+ * @param rows : Rows read (output)
+ */
+static void readReservoirs(vector<ReservoirRow> &rows) {
     fstream file;
     file.open("../Project1LargeDataSet/Reservoir.csv");
 //    file.open("../Project1DataSetSmall/Reservoirs_Madeira.csv");
@@ -38,18 +81,19 @@ void csvInfo::createReservoir() {
         getline(s, code, ',');
         getline(s, delivery);
 
-        Reservoir res = Reservoir(reservoir, municipality, stoi(id), code, stoi(delivery));
-        reservoirSet.insert(code);
-        reservoirsVector.push_back(res);
-        int aux = reservoirsVector.size();
-        pipesGraph.addVertex(code, 1, aux - 1);
+        rows.push_back({reservoir, municipality, stoi(id), code, stoi(delivery)});
     }
     file.close();
 }
 
-void csvInfo::createStations() {
-    stationSet.clear();
-    stationsVector.clear();
+/**
+ * @brief Reads the stations file
+ *
+ * Complexity: O(n)
+ *
+ * @param rows : Rows read (output)
+ */
+static void readStations(vector<StationRow> &rows) {
     fstream file;
     file.open("../Project1LargeDataSet/Stations.csv");
 //    file.open("../Project1DataSetSmall/Stations_Madeira.csv");
@@ -67,19 +111,19 @@ void csvInfo::createStations() {
         getline(s, id, ',');
         getline(s, code);
 
-        Station sta = Station(stoi(id), code);
-        stationSet.insert(code);
-        stationsVector.push_back(sta);
-        int aux = stationsVector.size();
-        pipesGraph.addVertex(code, 2, aux - 1);
+        rows.push_back({stoi(id), code});
     }
     file.close();
 }
 
-void csvInfo::createCities() {
-    cityMap.clear();
-    cityNameSet.clear();
-    citiesVector.clear();
+/**
+ * @brief Reads the cities file
+ *
+ * Complexity: O(n)
+ *
+ * @param rows : Rows read (output)
+ */
+static void readCities(vector<CityRow> &rows) {
     fstream file;
     file.open("../Project1LargeDataSet/Cities.csv");
 //    file.open("../Project1DataSetSmall/Cities_Madeira.csv");
@@ -88,13 +132,11 @@ void csvInfo::createCities() {
         return;
     }
 
-    int i = 0;
     string line;
     string city;
     string id;
     string code;
     string demand;
-    string none;
     string population;
     getline(file, line);    // discard header line
     while(getline(file, line)) {
@@ -105,52 +147,194 @@ void csvInfo::createCities() {
         getline(s, demand, ',');
         getline(s, population);
 
-        City res = City(city, stoi(id), code, stod(demand), stoi(population));
-        cityMap[city] = i;
-        cityNameSet.insert(city);
-        citiesVector.push_back(res);
-        int aux = citiesVector.size();
-        pipesGraph.addVertex(code, 0, aux - 1);
-        i++;
+        rows.push_back({city, stoi(id), code, stod(demand), stoi(population)});
     }
     file.close();
 }
 
-void csvInfo::createPipes() {
-    fstream file;
-    file.open("../Project1LargeDataSet/Pipes.csv");
-//    file.open("../Project1DataSetSmall/Pipes_Madeira.csv");
+/**
+ * @brief Parses the lines of the pipes file in [begin, end)
+ *
+ * Complexity: O(end - begin)
+ *
+ * @param text : Contents of the file
+ * @param begin : Start of the first line
+ * @param end : Past the last line
+ * @param pipes : Pipes read, in the order of the lines (output)
+ */
+static void parsePipes(const string &text, size_t begin, size_t end, vector<EdgeSpec> &pipes) {
+    while (begin < end) {
+        size_t lineEnd = text.find('\n', begin);
+        if (lineEnd == string::npos || lineEnd > end) lineEnd = end;
+        size_t p = begin;
+        auto field = [&](bool last) {
+            size_t e = last ? lineEnd : (size_t) (find(text.begin() + (ptrdiff_t) p, text.begin() + (ptrdiff_t) lineEnd, ',') - text.begin());
+            string f = text.substr(p, e - p);
+            p = min(e + 1, lineEnd);
+            return f;
+        };
+        if (lineEnd > begin) {
+            EdgeSpec pipe;
+            pipe.orig = field(false);
+            pipe.dest = field(false);
+            pipe.weight = stoi(field(false));
+            pipe.bidirectional = field(true) == "0";
+            pipes.push_back(pipe);
+        }
+        begin = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Reads the pipes file. A large file is split at line boundaries into chunks parsed by several threads, each
+ * into its own buffer, and the buffers are joined in file order.
+ *
+ * Complexity: O(n / threads + threads)
+ *
+ * @param pipes : Pipes read, in the order of the file (output)
+ */
+static void readPipes(vector<EdgeSpec> &pipes) {
+    ifstream file("../Project1LargeDataSet/Pipes.csv", ios::binary);
+//    ifstream file("../Project1DataSetSmall/Pipes_Madeira.csv", ios::binary);
     if (!file.is_open()) {
         cerr << "Error: Unable to open the file." << endl;
         return;
     }
+    file.seekg(0, ios::end);
+    string text(max((streamoff) 0, (streamoff) file.tellg()), '\0');
+    file.seekg(0, ios::beg);
+    file.read(&text[0], (streamsize) text.size());
+    text.resize((size_t) file.gcount());
+    file.close();
 
-    string line;
-    string A;
-    string B;
-    string capacity;
-    string direction;
+    size_t start = text.find('\n');    // discard header line
+    start = start == string::npos ? text.size() : start + 1;
+    size_t chunks = (text.size() - start) / PIPES_CHUNK_BYTES;
+    chunks = max((size_t) 1, min(chunks, (size_t) max(1u, thread::hardware_concurrency())));
+    vector<size_t> bounds(chunks + 1, text.size());
+    bounds[0] = start;
+    for (size_t k = 1; k < chunks; k++) {
+        size_t p = text.find('\n', max(start + (text.size() - start) / chunks * k, bounds[k - 1]));
+        bounds[k] = p == string::npos ? text.size() : p + 1;
+    }
 
-    getline(file, line);    // discard header line
-    while(getline(file, line)) {
-        stringstream s(line);
-        getline(s, A, ',');
-        getline(s, B, ',');
-        getline(s, capacity, ',');
-        getline(s, direction);
+    vector<vector<EdgeSpec>> parts(chunks);
+    WorkerPool pool((unsigned) chunks);
+    pool.run(chunks, [&](size_t k) { parsePipes(text, bounds[k], bounds[k + 1], parts[k]); });
+    size_t total = 0;
+    for (auto &part : parts) total += part.size();
+    pipes.reserve(pipes.size() + total);
+    for (auto &part : parts) move(part.begin(), part.end(), back_inserter(pipes));
+}
 
-        if (direction == "0") pipesGraph.addBidirectionalEdge(A, B, stoi(capacity));
-        else pipesGraph.addEdge(A, B, stoi(capacity));
+/**
+ * @brief Replaces the reservoirs by the rows read and adds them to the graph
+ *
+ * Complexity: O(n log(n))
+ *
+ * @param rows : Rows
+ */
+static void storeReservoirs(const vector<ReservoirRow> &rows) {
+    csvInfo::reservoirSet.clear();
+    csvInfo::reservoirsVector.clear();
+    for (const ReservoirRow &r : rows) {
+        csvInfo::reservoirSet.insert(r.code);
+        csvInfo::reservoirsVector.add(r.reservoir, r.municipality, r.id, r.code, r.delivery);
+        int aux = csvInfo::reservoirsVector.size();
+        csvInfo::pipesGraph.addVertex(r.code, 1, aux - 1);
     }
-    file.close();
+}
+
+/**
+ * @brief Replaces the stations by the rows read and adds them to the graph
+ *
+ * Complexity: O(n log(n))
+ *
+ * @param rows : Rows
+ */
+static void storeStations(const vector<StationRow> &rows) {
+    csvInfo::stationSet.clear();
+    csvInfo::stationsVector.clear();
+    for (const StationRow &r : rows) {
+        csvInfo::stationSet.insert(r.code);
+        csvInfo::stationsVector.add(r.id, r.code);
+        int aux = csvInfo::stationsVector.size();
+        csvInfo::pipesGraph.addVertex(r.code, 2, aux - 1);
+    }
+}
+
+/**
+ * @brief Replaces the cities by the rows read and adds them to the graph
+ *
+ * Complexity: O(n log(n))
+ *
+ * @param rows : Rows
+ */
+static void storeCities(const vector<CityRow> &rows) {
+    csvInfo::cityMap.clear();
+    csvInfo::cityNameSet.clear();
+    csvInfo::citiesVector.clear();
+    int i = 0;
+    for (const CityRow &r : rows) {
+        csvInfo::cityMap[r.city] = i;
+        csvInfo::cityNameSet.insert(r.city);
+        csvInfo::citiesVector.add(r.city, r.id, r.code, r.demand, r.population);
+        int aux = csvInfo::citiesVector.size();
+        csvInfo::pipesGraph.addVertex(r.code, 0, aux - 1);
+        i++;
+    }
+}
+
+void csvInfo::createReservoir() {
+    vector<ReservoirRow> rows;
+    readReservoirs(rows);
+    storeReservoirs(rows);
+}
+
+void csvInfo::createStations() {
+    vector<StationRow> rows;
+    readStations(rows);
+    storeStations(rows);
+}
+
+void csvInfo::createCities() {
+    vector<CityRow> rows;
+    readCities(rows);
+    storeCities(rows);
+}
+
+void csvInfo::createPipes() {
+    vector<EdgeSpec> pipes;
+    readPipes(pipes);
+    pipesGraph.addEdges(pipes);
+}
+
+void csvInfo::loadAll() {
+    vector<ReservoirRow> reservoirs;
+    vector<StationRow> stations;
+    vector<CityRow> cities;
+    vector<EdgeSpec> pipes;
+    thread reservoirsReader(readReservoirs, ref(reservoirs));
+    thread stationsReader(readStations, ref(stations));
+    thread citiesReader(readCities, ref(cities));
+    readPipes(pipes);
+    reservoirsReader.join();
+    stationsReader.join();
+    citiesReader.join();
+
+    // same vertex order as creating them one file at a time
+    storeReservoirs(reservoirs);
+    storeStations(stations);
+    storeCities(cities);
+    pipesGraph.addEdges(pipes);
 }
 
 void csvInfo::writeToMaxWaterPerCity(const vector<vector<string>>& v) {
-    ofstream fileName;
-    fileName.open("../outputFiles/maxWaterPerCity.csv");
-    fileName << "CityName,CityCode,MaxWater" << endl;
-    for (vector<string> i : v) {
-        fileName << i[0] << "," << i[1] << "," << i[2] << endl;
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/maxWaterPerCity",
+                                                       {{"CityName", TEXT_COLUMN}, {"CityCode", TEXT_COLUMN}, {"MaxWater", NUMBER_COLUMN}});
+    if (file == nullptr) return;
+    for (const vector<string>& i : v) {
+        file->add(i[0]).add(i[1]).add(i[2]).endRow();
     }
-    fileName.close();
+    file->close();
 }
\ No newline at end of file
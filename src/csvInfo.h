@@ -20,19 +20,24 @@ public:
     csvInfo();
 
     /**
-     * Vector of all the reservoirs
+     * Pool of the names and codes of all the reservoirs, stations and cities
      */
-    static vector<Reservoir> reservoirsVector;
+    static StringPool strings;
 
     /**
-     * Vector of all the stations
+     * Table of all the reservoirs
      */
-    static vector<Station> stationsVector;
+    static ReservoirTable reservoirsVector;
 
     /**
-     * Vector of all the cities
+     * Table of all the stations
      */
-    static vector<City> citiesVector;
+    static StationTable stationsVector;
+
+    /**
+     * Table of all the cities
+     */
+    static CityTable citiesVector;
 
     /**
      * Graph of all the pipes
@@ -60,21 +65,21 @@ public:
     static std::set<std::string> cityNameSet;
 
     /**
-     * @brief Creates a set with the code of all reservoirs and a vector with the info of all reservoirs
+     * @brief Creates a set with the code of all reservoirs and a table with the info of all reservoirs
      *
      * Complexity: O(n log(n))
      */
     static void createReservoir();
 
     /**
-     * @brief Creates a set with the code of all stations and a vector with the info of all stations
+     * @brief Creates a set with the code of all stations and a table with the info of all stations
      *
      * Complexity: O(n log(n))
      */
     static void createStations();
 
     /**
-     * @brief Creates a set with the name of all cities and a vector with the info of all cities
+     * @brief Creates a set with the name of all cities and a table with the info of all cities
      *
      * Complexity: O(n log(n))
      */
@@ -88,7 +93,16 @@ public:
     static void createPipes();
 
     /**
-     * @brief Write information present in the vector to file MaxWaterPerCity.csv
+     * @brief Reads the four files at the same time (the pipes file itself in parallel chunks when it is large), then
+     * adds the reservoirs, stations and cities to the graph, and all the pipes in one pass (the same result as calling
+     * createReservoir, createStations, createCities and createPipes in this order)
+     *
+     * Complexity: O(n log(n)), the reading spread over the threads
+     */
+    static void loadAll();
+
+    /**
+     * @brief Write information present in the vector to file maxWaterPerCity (in the format of ResultWriter::format)
      *
      * Complexity: O(n)
      *
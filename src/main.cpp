@@ -20,11 +20,22 @@
 #include <stack>
 #include <chrono>
 #include <cmath>
+#include <climits>
+#include <algorithm>
 #include "src/AuxFunctions.h"
+#include "src/ResultCache.h"
+#include "src/TimeSimulation.h"
+#include "src/UpgradePlanner.h"
+#include "src/Sensitivity.h"
+#include "src/ResultWriter.h"
+#include "src/QueryServer.h"
+#include "src/NetworkEditor.h"
+#include "src/NetworkStats.h"
+#include "src/CriticalElements.h"
 
 void clearMenus();
 
-int main();
+int main(int argc, char* argv[]);
 void mainMenu();
 void amountWaterEachCity();
 void amountWaterOneCity();
@@ -34,11 +45,20 @@ void pumpingStationRemoval();
 void pipelineFailures();
 void balanceNetwork();
 void reservoirRemovalPart();
+void scenarioEvaluation();
+void reservoirRemovalSweep();
+void timeSimulation();
+void demandReplay();
+void upgradePlanning();
+void sensitivityAnalysis();
+void waterOrigins();
+void outputFormat();
+void networkEdits();
 
 bool verifyCity(string basicString);
 bool verifyReservoir(string code);
 
-map<string, int> m = {{"main", 0}, {"waterEach", 1}, {"waterSpecific", 2}, {"waterNeedCheck", 3}, {"balanceNetwork", 4}, {"reservoirRemoval", 5}, {"reservoirRemovalPart", 6}, {"stationRemoval",7}, {"pipelineFailures", 8}};
+map<string, int> m = {{"main", 0}, {"waterEach", 1}, {"waterSpecific", 2}, {"waterNeedCheck", 3}, {"balanceNetwork", 4}, {"reservoirRemoval", 5}, {"reservoirRemovalPart", 6}, {"stationRemoval",7}, {"pipelineFailures", 8}, {"scenarios", 9}, {"reservoirSweep", 10}, {"timeSimulation", 11}, {"demandReplay", 12}, {"upgradePlanning", 13}, {"sensitivity", 14}, {"waterOrigins", 15}, {"outputFormat", 16}, {"networkEdits", 17}};
 stack<string> menus;
 bool over = false;
 bool quit = false;
@@ -56,17 +76,19 @@ void clearMenus() {
 }
 
 /**
- * @brief Main function to initialize data and run the program.
+ * @brief Main function to initialize data and run the program. With "--serve <socket>" it answers queries over a
+ * Unix domain socket instead of showing the menus (see QueryServer).
  *
  * Complexity: O(???)
  *
+ * @param argc : Number of arguments
+ * @param argv : Arguments
  * @return Program exit status.
  */
-int main() {
-    csvInfo::createReservoir();
-    csvInfo::createStations();
-    csvInfo::createCities();
-    csvInfo::createPipes();
+int main(int argc, char* argv[]) {
+    csvInfo::loadAll();
+
+    if (argc >= 3 && string(argv[1]) == "--serve") return QueryServer::serve(argv[2]);
 
     menus.emplace("main");
     while (true) {
@@ -99,6 +121,33 @@ int main() {
             case 8:
                 pipelineFailures();
                 break;
+            case 9:
+                scenarioEvaluation();
+                break;
+            case 10:
+                reservoirRemovalSweep();
+                break;
+            case 11:
+                timeSimulation();
+                break;
+            case 12:
+                demandReplay();
+                break;
+            case 13:
+                upgradePlanning();
+                break;
+            case 14:
+                sensitivityAnalysis();
+                break;
+            case 15:
+                waterOrigins();
+                break;
+            case 16:
+                outputFormat();
+                break;
+            case 17:
+                networkEdits();
+                break;
             default:
                 quit = true;
         }
@@ -156,6 +205,15 @@ void mainMenu() {
     cout << "6 - (T3.1) Water reservoir out of comission (without running Max Flow from scratch)." << endl;
     cout << "7 - (T3.2) Pumping stations removal consequences." << endl;
     cout << "8 - (T3.3) Pipeline failures consequences." << endl;
+    cout << "9 - Evaluate a file of what-if scenarios." << endl;
+    cout << "10 - (T3.1) Reservoirs removal consequences, ranked by lost delivery." << endl;
+    cout << "11 - Simulate deliveries over a horizon of periods, with demand profiles and reservoir storage." << endl;
+    cout << "12 - Replay a demand time series and get the deficit of each city over time." << endl;
+    cout << "13 - Plan pipe upgrades within a budget." << endl;
+    cout << "14 - Sensitivity of the max flow to the capacity of each pipe, reservoir and city." << endl;
+    cout << "15 - Reservoirs each city gets its water from, and the paths it takes." << endl;
+    cout << "16 - Format of the output files (now " << ResultWriter::extension() << ")." << endl;
+    cout << "17 - Apply a file of live network edits, keeping the max flow up to date." << endl;
     cout << "0 - Quit." << endl;
     cout << endl;
     cout << "Note: If you enter a 'q' when asked for an input," << endl;
@@ -191,11 +249,38 @@ void mainMenu() {
                 case 8:
                     menus.emplace("pipelineFailures");
                     return;
+                case 9:
+                    menus.emplace("scenarios");
+                    return;
+                case 10:
+                    menus.emplace("reservoirSweep");
+                    return;
+                case 11:
+                    menus.emplace("timeSimulation");
+                    return;
+                case 12:
+                    menus.emplace("demandReplay");
+                    return;
+                case 13:
+                    menus.emplace("upgradePlanning");
+                    return;
+                case 14:
+                    menus.emplace("sensitivity");
+                    return;
+                case 15:
+                    menus.emplace("waterOrigins");
+                    return;
+                case 16:
+                    menus.emplace("outputFormat");
+                    return;
+                case 17:
+                    menus.emplace("networkEdits");
+                    return;
                 case 0:
                     quit = true;
                     return;
                 default:
-                    cout << "Invalid number! The number should be between 0 and 7." << endl;
+                    cout << "Invalid number! The number should be between 0 and 17." << endl;
             }
         }
         else {
@@ -235,7 +320,7 @@ void amountWaterOneCity() {
         }
     }
 
-    AuxFunctions::MaxFlow(true);
+    AuxFunctions::MaxFlow(false);
     cout << "Name, Code, Water" << endl;
     cout << AuxFunctions::maxWaterPerCity[csvInfo::cityMap[city]][0] << "," << AuxFunctions::maxWaterPerCity[csvInfo::cityMap[city]][1] << "," << AuxFunctions::maxWaterPerCity[csvInfo::cityMap[city]][2] << endl;
     over = true;
@@ -268,10 +353,15 @@ void waterNeedCheck(){
     vector<string> final;
     stringstream  aux;
 
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/waterNeeds",
+                                                       {{"CityName", TEXT_COLUMN}, {"CityCode", TEXT_COLUMN}, {"Deficit", NUMBER_COLUMN}});
+
     cout << "Name, Code, Deficit" << endl;
     unsigned int t = AuxFunctions::maxWaterPerCity.size();
     for (int i = 0; i<t;i++){
         if (csvInfo::citiesVector[i].getDemand() > stoi(AuxFunctions::maxWaterPerCity[i][2])) {
+            if (file != nullptr) file->add(csvInfo::citiesVector[i].getCity()).add(csvInfo::citiesVector[i].getCode())
+                                     .add(stod(AuxFunctions::maxWaterPerCity[i][2]) - csvInfo::citiesVector[i].getDemand()).endRow();
             aux << csvInfo::citiesVector[i].getCity() << "," << csvInfo::citiesVector[i].getCode() << ",-" << csvInfo::citiesVector[i].getDemand() - stod(AuxFunctions::maxWaterPerCity[i][2]);
             final.push_back(aux.str());
             aux.str("");
@@ -324,6 +414,9 @@ void simulateReservoirRemoval(){
     double maxFlow = 0;
 
     AuxFunctions::simulateReservoirRemoval(code);
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/reservoirRemoval",
+                                                       {{"ReservoirCode", TEXT_COLUMN}, {"CityName", TEXT_COLUMN},
+                                                        {"CityCode", TEXT_COLUMN}, {"Deficit", NUMBER_COLUMN}});
 
     cout << "Name, Code, Deficit" << endl;
     for (auto a: AuxFunctions::maxWaterPerCity) {
@@ -332,6 +425,7 @@ void simulateReservoirRemoval(){
             if (a[1] == b.getCode() && stoi(a[2]) < b.getDemand()) {
                 int d = b.getDemand() - stoi(a[2]);
                 cout << a[0] << "," << a[1] << ",-" << d << endl;
+                if (file != nullptr) file->add(code).add(a[0]).add(a[1]).add((double) -d).endRow();
                 break;
             }
         }
@@ -347,23 +441,42 @@ void simulateReservoirRemoval(){
  */
 void pumpingStationRemoval(){
     AuxFunctions::MaxFlow(false);
+    shared_ptr<const FlowNetwork> solved = ResultCache::solvedNetwork();
+    const FlowNetwork &baseline = *solved;
+    DominatorTree dominators(baseline);
+    CriticalElements critical = CriticalElements::fromPipesGraph();
     unsigned int t = csvInfo::stationsVector.size();
+    int solves = 0;
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/stationRemoval",
+                                                       {{"StationCode", TEXT_COLUMN}, {"CityName", TEXT_COLUMN},
+                                                        {"CityCode", TEXT_COLUMN}, {"Deficit", NUMBER_COLUMN},
+                                                        {"Disconnected", TEXT_COLUMN}});
+    cout << critical.numCriticalStations() << " stations disconnect cities from every reservoir" << endl;
     cout << "Station: Name, Code, Deficit" << endl;
 
     for (int i = 0; i<t; i++){
 
-        AuxFunctions::simulatePumpingStationRemoval(csvInfo::stationsVector[i].getCode());
+        // only stations the dominator tree says nothing certain about are solved again
+        if (!AuxFunctions::screenPumpingStationRemoval(csvInfo::stationsVector[i].getCode(), baseline, dominators)) {
+            AuxFunctions::simulatePumpingStationRemoval(csvInfo::stationsVector[i].getCode());
+            solves++;
+        }
+        vector<string> cutOff = critical.getCutOffCities(csvInfo::pipesGraph.findVertex(csvInfo::stationsVector[i].getCode()));
         cout << endl << csvInfo::stationsVector[i].getCode() << ":" << endl;
         for (auto a : AuxFunctions::maxWaterPerCity) {
             for(auto b : csvInfo::citiesVector) {
                 if (a[1] == b.getCode() && stoi(a[2]) < b.getDemand()) {
                     int d = b.getDemand() - stoi(a[2]);
-                    cout << "         " << a[0] << "," << a[1] << ",-" << d << endl;
+                    bool disconnected = find(cutOff.begin(), cutOff.end(), a[1]) != cutOff.end();
+                    cout << "         " << a[0] << "," << a[1] << ",-" << d << (disconnected ? " (disconnected)" : "") << endl;
+                    if (file != nullptr) file->add(csvInfo::stationsVector[i].getCode()).add(a[0]).add(a[1]).add((double) -d)
+                                             .add(disconnected ? "yes" : "no").endRow();
                     break;
                 }
             }
         }
     }
+    cout << endl << solves << " of " << t << " stations needed a new max flow" << endl;
     over = true;
 }
 
@@ -375,11 +488,18 @@ void pumpingStationRemoval(){
 void pipelineFailures() {
     AuxFunctions::MaxFlow(false);
     vector<vector<string>> initial = AuxFunctions::maxWaterPerCity;
+    CriticalElements critical = CriticalElements::fromPipesGraph();
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/pipelineFailures",
+                                                       {{"PointA", TEXT_COLUMN}, {"PointB", TEXT_COLUMN}, {"CityName", TEXT_COLUMN},
+                                                        {"CityCode", TEXT_COLUMN}, {"Deficit", NUMBER_COLUMN},
+                                                        {"Disconnected", TEXT_COLUMN}});
 
+    cout << critical.numCriticalPipes() << " pipes disconnect cities from every reservoir" << endl;
     cout << "Pipeline: Name, Code, Deficit" << endl << endl;
     for (Vertex* v : csvInfo::pipesGraph.getVertexSet()) {
         for (Edge* e : v->getAdj()) {
             bool failure = false;
+            vector<string> cutOff = critical.getCutOffCities(e);
 
             AuxFunctions::simulatePipelineFailure(e);
             cout << endl << e->getOrig()->getInfo() << " -> " << e->getDest()->getInfo() << ": " << endl;
@@ -389,7 +509,10 @@ void pipelineFailures() {
                     if (a[1] == b[1] && stoi(a[2]) < stoi(b[2])) {
                         failure = true;
                         int d = csvInfo::citiesVector[i].getDemand() - stoi(a[2]);
-                        cout << "          " << a[0] << "," << a[1] << ",-" << d << endl;
+                        bool disconnected = find(cutOff.begin(), cutOff.end(), a[1]) != cutOff.end();
+                        cout << "          " << a[0] << "," << a[1] << ",-" << d << (disconnected ? " (disconnected)" : "") << endl;
+                        if (file != nullptr) file->add(e->getOrig()->getInfo()).add(e->getDest()->getInfo()).add(a[0]).add(a[1])
+                                                 .add((double) -d).add(disconnected ? "yes" : "no").endRow();
                         break;
                     }
                 }
@@ -409,12 +532,36 @@ void pipelineFailures() {
  */
 void balanceNetwork() {
     AuxFunctions::MaxFlow(false);
-    vector<double> initial_metrics = AuxFunctions::compute_metrics();
+    NetworkStats initial = NetworkStats::fromPipesGraph();
 
     AuxFunctions::balanceNetwork();
 
-    vector<double> final_metrics = AuxFunctions::compute_metrics();
+    NetworkStats final = NetworkStats::fromPipesGraph();
+    vector<double> initial_metrics = initial.getMetrics(), final_metrics = final.getMetrics();
     AuxFunctions::print_metrics(initial_metrics, final_metrics);
+
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/balanceMetrics",
+                                                       {{"Metric", TEXT_COLUMN}, {"Initial", NUMBER_COLUMN}, {"Final", NUMBER_COLUMN}});
+    string names[7] = {"MaxFlow", "Average", "Variance", "MaxDiff", "Median", "P90", "P99"};
+    for (int i = 0; i < 7 && file != nullptr; i++) file->add(names[i]).add(initial_metrics[i]).add(final_metrics[i]).endRow();
+
+    file = ResultWriter::open("../outputFiles/balanceUtilization",
+                              {{"Utilization", TEXT_COLUMN}, {"Initial", NUMBER_COLUMN}, {"Final", NUMBER_COLUMN}});
+    for (int b = 0; b < UTILIZATION_BUCKETS && file != nullptr; b++) {
+        string range = to_string(b * 100 / UTILIZATION_BUCKETS) + "-" + to_string((b + 1) * 100 / UTILIZATION_BUCKETS) + "%";
+        file->add(range).add((double) initial.overall.histogram[b]).add((double) final.overall.histogram[b]).endRow();
+    }
+
+    file = ResultWriter::open("../outputFiles/balanceByMunicipality",
+                              {{"Municipality", TEXT_COLUMN}, {"Pipes", NUMBER_COLUMN}, {"InitialAverage", NUMBER_COLUMN},
+                               {"FinalAverage", NUMBER_COLUMN}, {"InitialVariance", NUMBER_COLUMN}, {"FinalVariance", NUMBER_COLUMN},
+                               {"InitialMaxDiff", NUMBER_COLUMN}, {"FinalMaxDiff", NUMBER_COLUMN}});
+    for (size_t m = 0; m < final.municipalities.size() && file != nullptr; m++) {
+        const PipeStats &i = initial.byMunicipality[m], &f = final.byMunicipality[m];
+        if (f.count == 0) continue;
+        file->add(final.municipalities[m]).add((double) f.count).add(i.mean).add(f.mean).add(i.variance).add(f.variance)
+            .add(i.max).add(f.max).endRow();
+    }
     over = true;
 }
 
@@ -449,6 +596,9 @@ void reservoirRemovalPart() {
     cout << endl;
 
     AuxFunctions::simulateReservoirRemovalPart(code);
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/reservoirRemovalPart",
+                                                       {{"ReservoirCode", TEXT_COLUMN}, {"CityName", TEXT_COLUMN},
+                                                        {"CityCode", TEXT_COLUMN}, {"Deficit", NUMBER_COLUMN}});
 
     cout << "Name, Code, Deficit" << endl;
     double m = 0;
@@ -458,6 +608,7 @@ void reservoirRemovalPart() {
             if (a[1] == b.getCode() && stoi(a[2]) < b.getDemand()) {
                 int d = b.getDemand() - stoi(a[2]);
                 cout << a[0] << "," << a[1] << ",-" << d << endl;
+                if (file != nullptr) file->add(code).add(a[0]).add(a[1]).add((double) -d).endRow();
                 break;
             }
         }
@@ -466,6 +617,436 @@ void reservoirRemovalPart() {
     over = true;
 }
 
+/**
+ * @brief Evaluates every scenario of a file, warm-started from the baseline max flow, and writes the deficits to
+ * scenarioDeficits.csv
+ *
+ * Complexity: O(S V E^2 / threads)
+ */
+void scenarioEvaluation() {
+    string path;
+    getline(cin, path);
+    while (true) {
+        cout << "Enter the path of the scenario file: ";
+        if (getline(cin, path)) {
+            if (path == "q") {
+                menus.pop();
+                return;
+            }
+            break;
+        }
+        else {
+            cout << "Invalid input! Please enter a valid path." << endl;
+            cin.clear();          // Clear the error state
+            cin.ignore(INT_MAX , '\n'); // Ignore the invalid input
+        }
+    }
+    cout << endl;
+
+    shared_ptr<const FlowNetwork> solved = ResultCache::solvedNetwork();
+    const FlowNetwork& baseline = *solved;
+    vector<Scenario> scenarios = ScenarioEngine::readScenarios(path, baseline);
+    vector<ScenarioResult> results = ScenarioEngine::evaluateAll(baseline, scenarios);
+
+    cout << "Scenario, Max Flow, Deficit" << endl;
+    cout << "baseline," << baseline.getFlowValue() << "," << endl;
+    for (const ScenarioResult& r : results) {
+        double deficit = 0;
+        for (int i = 0; i < (int) r.cityFlows.size(); i++) {
+            if (r.cityFlows[i] < r.demands[i]) deficit += r.demands[i] - r.cityFlows[i];
+        }
+        cout << r.name << "," << r.maxFlow << ",-" << deficit << endl;
+    }
+    ScenarioEngine::writeDeficitReport("../outputFiles/scenarioDeficits", results, baseline.getCityFlows());
+    cout << endl << "Deficits per city written to outputFiles/scenarioDeficits" << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Removes each reservoir in turn (in parallel, warm-started from the baseline max flow) and ranks reservoirs by
+ * the delivery lost, and the affected cities of each one by the water they lose
+ *
+ * Complexity: O(R V E^2 / threads)
+ */
+void reservoirRemovalSweep() {
+    shared_ptr<const FlowNetwork> solved = ResultCache::solvedNetwork();
+    const FlowNetwork& baseline = *solved;
+    vector<double> initial = baseline.getCityFlows();
+    vector<ScenarioResult> results = ScenarioEngine::evaluateAll(baseline, ScenarioEngine::reservoirRemovalScenarios(baseline));
+
+    vector<int> order(results.size());
+    for (int i = 0; i < (int) order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return results[a].maxFlow < results[b].maxFlow; });
+
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/reservoirSweep",
+                                                       {{"ReservoirCode", TEXT_COLUMN}, {"LostDelivery", NUMBER_COLUMN},
+                                                        {"CityName", TEXT_COLUMN}, {"CityCode", TEXT_COLUMN},
+                                                        {"Lost", NUMBER_COLUMN}, {"Deficit", NUMBER_COLUMN}});
+
+    cout << "Reservoir: Name, Code, Lost Delivery" << endl;
+    cout << "          City: Name, Code, Lost, Deficit" << endl;
+    for (int r : order) {
+        const ScenarioResult& res = results[r];
+        cout << endl << csvInfo::reservoirsVector[r].getReservoir() << "," << res.name << ",-"
+             << baseline.getFlowValue() - res.maxFlow << endl;
+
+        vector<pair<double, int>> affected;
+        for (int i = 0; i < (int) res.cityFlows.size(); i++) {
+            if (res.cityFlows[i] < initial[i]) affected.emplace_back(initial[i] - res.cityFlows[i], i);
+        }
+        sort(affected.begin(), affected.end(), [](const pair<double, int>& a, const pair<double, int>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+        if (affected.empty()) cout << "          There are no consequences!" << endl;
+        for (auto& a : affected) {
+            int i = a.second;
+            cout << "          " << csvInfo::citiesVector[i].getCity() << "," << csvInfo::citiesVector[i].getCode() << ",-"
+                 << a.first << ",-" << res.demands[i] - res.cityFlows[i] << endl;
+            if (file != nullptr) file->add(res.name).add(res.maxFlow - baseline.getFlowValue()).add(csvInfo::citiesVector[i].getCity())
+                                     .add(csvInfo::citiesVector[i].getCode()).add(-a.first).add(res.cityFlows[i] - res.demands[i]).endRow();
+        }
+    }
+    over = true;
+}
+
+/**
+ * @brief Simulates a horizon of periods with the demand profiles and reservoir storage of two files, writing the results
+ * of each period to timeSimulationCities.csv and timeSimulationReservoirs.csv
+ *
+ * Complexity: O(T V E^2)
+ */
+void timeSimulation() {
+    string paths[2];
+    string prompts[2] = {"Enter the path of the demand profiles file: ", "Enter the path of the reservoir storage file: "};
+    getline(cin, paths[0]);
+    for (int i = 0; i < 2; i++) {
+        while (true) {
+            cout << prompts[i];
+            if (getline(cin, paths[i])) {
+                if (paths[i] == "q") {
+                    menus.pop();
+                    return;
+                }
+                break;
+            }
+            else {
+                cout << "Invalid input! Please enter a valid path." << endl;
+                cin.clear();          // Clear the error state
+                cin.ignore(INT_MAX , '\n'); // Ignore the invalid input
+            }
+        }
+    }
+
+    long long periods;
+    while (true) {
+        cout << "Enter the number of periods: ";
+        if (cin >> periods && periods > 0) break;
+        if (cin.fail()) {
+            cin.clear();
+            string input;
+            cin >> input;
+            if (input == "q") {
+                menus.pop();
+                return;
+            }
+        }
+        cout << "Invalid input! Please enter a positive number." << endl;
+    }
+    cout << endl;
+
+    vector<vector<double>> profiles;
+    vector<ReservoirStorage> storage;
+    if (!TimeSimulation::readDemandProfiles(paths[0], profiles) || !TimeSimulation::readStorage(paths[1], storage)) {
+        over = true;
+        return;
+    }
+    SimulationSummary s = TimeSimulation::run(profiles, storage, periods, "../outputFiles/timeSimulationCities",
+                                              "../outputFiles/timeSimulationReservoirs");
+
+    cout << "Periods: " << s.periods << endl;
+    cout << "Periods with deficit: " << s.periodsInDeficit << endl;
+    cout << "Total demand: " << s.demand << endl;
+    cout << "Total delivered: " << s.delivered << endl;
+    cout << "Total deficit: -" << s.demand - s.delivered << endl;
+    cout << endl << "Results per period written to outputFiles/timeSimulationCities" << ResultWriter::extension()
+         << " and outputFiles/timeSimulationReservoirs" << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Replays a demand time series, re-solving the max flow incrementally at each timestamp, and writes the water and
+ * deficit of each city over time to demandReplay.csv
+ *
+ * Complexity: O(n + T V E^2)
+ */
+void demandReplay() {
+    string path;
+    getline(cin, path);
+    while (true) {
+        cout << "Enter the path of the demand time series file: ";
+        if (getline(cin, path)) {
+            if (path == "q") {
+                menus.pop();
+                return;
+            }
+            break;
+        }
+        else {
+            cout << "Invalid input! Please enter a valid path." << endl;
+            cin.clear();          // Clear the error state
+            cin.ignore(INT_MAX , '\n'); // Ignore the invalid input
+        }
+    }
+    cout << endl;
+
+    SimulationSummary s = TimeSimulation::replayDemands(path, "../outputFiles/demandReplay");
+    cout << "Timestamps: " << s.periods << endl;
+    cout << "Timestamps with deficit: " << s.periodsInDeficit << endl;
+    cout << "Total demand: " << s.demand << endl;
+    cout << "Total delivered: " << s.delivered << endl;
+    cout << "Total deficit: -" << s.demand - s.delivered << endl;
+    cout << endl << "Deficit time series written to outputFiles/demandReplay" << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Chooses the pipe upgrades of a file that deliver the most water within a budget, and writes them to
+ * upgradePlan.csv
+ *
+ * Complexity: O(k n V E^2 / threads)
+ */
+void upgradePlanning() {
+    string path;
+    getline(cin, path);
+    while (true) {
+        cout << "Enter the path of the pipe upgrades file: ";
+        if (getline(cin, path)) {
+            if (path == "q") {
+                menus.pop();
+                return;
+            }
+            break;
+        }
+        else {
+            cout << "Invalid input! Please enter a valid path." << endl;
+            cin.clear();          // Clear the error state
+            cin.ignore(INT_MAX , '\n'); // Ignore the invalid input
+        }
+    }
+
+    double budget;
+    while (true) {
+        cout << "Enter the budget: ";
+        if (cin >> budget && budget >= 0) break;
+        if (cin.fail()) {
+            cin.clear();
+            string input;
+            cin >> input;
+            if (input == "q") {
+                menus.pop();
+                return;
+            }
+        }
+        cout << "Invalid input! Please enter a positive number." << endl;
+    }
+    cout << endl;
+
+    shared_ptr<const FlowNetwork> solved = ResultCache::solvedNetwork();
+    const FlowNetwork& baseline = *solved;
+    vector<UpgradeOption> options = UpgradePlanner::readOptions(path, baseline);
+    vector<UpgradeStep> steps = UpgradePlanner::plan(baseline, options, budget);
+
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/upgradePlan",
+                                                       {{"PointA", TEXT_COLUMN}, {"PointB", TEXT_COLUMN}, {"Cost", NUMBER_COLUMN},
+                                                        {"Increase", NUMBER_COLUMN}, {"Gain", NUMBER_COLUMN},
+                                                        {"MaxFlow", NUMBER_COLUMN}});
+    double spent = 0;
+    cout << "Initial Max Flow: " << baseline.getFlowValue() << endl;
+    cout << "Pipe, Cost, Increase, Gain, Max Flow" << endl;
+    for (const UpgradeStep& step : steps) {
+        const UpgradeOption& o = options[step.option];
+        spent += o.cost;
+        cout << o.pointA << "->" << o.pointB << "," << o.cost << "," << o.increase << ",+" << step.gain << "," << step.maxFlow << endl;
+        if (file != nullptr) file->add(o.pointA).add(o.pointB).add(o.cost).add(o.increase).add(step.gain).add(step.maxFlow).endRow();
+    }
+    if (file != nullptr) file->close();
+    if (steps.empty()) cout << "No upgrade within the budget increases the water delivered." << endl;
+    cout << endl << "Spent: " << spent << " of " << budget << endl;
+    cout << "Plan written to outputFiles/upgradePlan" << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Computes how much the max flow changes when the capacity of each pipe, reservoir and city goes up or down by
+ * one unit or a percentage, shows the most sensitive ones and writes all of them to sensitivity.csv
+ *
+ * Complexity: O(V + E + k V E^2 / threads)
+ */
+void sensitivityAnalysis() {
+    double percent;
+    while (true) {
+        cout << "Enter the capacity change in % (0 for one unit): ";
+        if (cin >> percent && percent >= 0) break;
+        if (cin.fail()) {
+            cin.clear();
+            string input;
+            cin >> input;
+            if (input == "q") {
+                menus.pop();
+                return;
+            }
+        }
+        cout << "Invalid input! Please enter a positive number." << endl;
+    }
+    cout << endl;
+
+    auto start = chrono::steady_clock::now();
+    shared_ptr<const FlowNetwork> solved = ResultCache::solvedNetwork();
+    const FlowNetwork& baseline = *solved;
+    int solves = 0;
+    vector<SensitivityEntry> entries = Sensitivity::analyse(baseline, percent, solves);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    const int TOP = 10;
+    vector<int> order(entries.size());
+    for (int i = 0; i < (int) order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return entries[a].gain > entries[b].gain; });
+    cout << "Largest gains: Type, Element, Capacity, Delta, Gain" << endl;
+    for (int i = 0; i < TOP && i < (int) order.size() && entries[order[i]].gain > 0; i++) {
+        const SensitivityEntry& e = entries[order[i]];
+        cout << "          " << e.type << "," << e.element << "," << e.capacity << ",+" << e.delta << ",+" << e.gain << endl;
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return entries[a].loss > entries[b].loss; });
+    cout << "Largest losses: Type, Element, Capacity, Delta, Loss" << endl;
+    for (int i = 0; i < TOP && i < (int) order.size() && entries[order[i]].loss > 0; i++) {
+        const SensitivityEntry& e = entries[order[i]];
+        cout << "          " << e.type << "," << e.element << "," << e.capacity << ",-" << e.delta << ",-" << e.loss << endl;
+    }
+
+    Sensitivity::writeReport("../outputFiles/sensitivity", entries);
+    cout << endl << entries.size() << " elements analysed, " << solves << " changes re-solved, in " << ms << " ms" << endl;
+    cout << "Sensitivity of every element written to outputFiles/sensitivity" << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Decomposes the max flow into reservoir to city paths, shows how much water each city gets from each reservoir
+ * and writes the paths to waterPaths.csv
+ *
+ * Complexity: O(E * (V + paths) + R C)
+ */
+void waterOrigins() {
+    shared_ptr<const FlowNetwork> solved;
+    shared_ptr<const FlowDecomposition> decomposition = ResultCache::solvedDecomposition(solved);
+    const FlowNetwork& net = *solved;
+    const FlowDecomposition& d = *decomposition;
+
+    cout << "City: Name, Code, Water" << endl;
+    cout << "          Reservoir: Name, Code, Water" << endl;
+    for (int c = 0; c < (int) csvInfo::citiesVector.size(); c++) {
+        cout << endl << csvInfo::citiesVector[c].getCity() << "," << csvInfo::citiesVector[c].getCode() << ","
+             << d.getCityWater(c) << endl;
+        for (int r = 0; r < (int) csvInfo::reservoirsVector.size(); r++) {
+            if (d.getWater(r, c) <= 0) continue;
+            cout << "          " << csvInfo::reservoirsVector[r].getReservoir() << "," << csvInfo::reservoirsVector[r].getCode()
+                 << "," << d.getWater(r, c) << endl;
+        }
+    }
+
+    unique_ptr<ResultWriter> file = ResultWriter::open("../outputFiles/waterPaths",
+                                                       {{"ReservoirCode", TEXT_COLUMN}, {"CityCode", TEXT_COLUMN},
+                                                        {"Water", NUMBER_COLUMN}, {"Path", TEXT_COLUMN}});
+    if (file == nullptr) {
+        over = true;
+        return;
+    }
+    for (int p = 0; p < d.numPaths(); p++) {
+        string path = csvInfo::reservoirsVector[d.getPathReservoir(p)].getCode();
+        for (const FlowId* a = d.pathBegin(p); a != d.pathEnd(p); a++) path += " -> " + net.getCode(net.getHead(*a));
+        file->add(csvInfo::reservoirsVector[d.getPathReservoir(p)].getCode()).add(csvInfo::citiesVector[d.getPathCity(p)].getCode())
+             .add(d.getPathFlow(p)).add(path).endRow();
+    }
+    file->close();
+    cout << endl << d.numPaths() << " paths written to outputFiles/waterPaths" << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Chooses the format of the files written by the analyses
+ *
+ * Complexity: O(1)
+ */
+void outputFormat() {
+    cout << "1 - CSV (.csv)" << endl;
+    cout << "2 - JSON Lines (.jsonl)" << endl;
+    cout << "3 - Columnar binary, for very large outputs (.col)" << endl;
+    int op;
+    while (true) {
+        cout << "Write the number of the format: ";
+        if (cin >> op && op >= 1 && op <= 3) break;
+        if (cin.fail()) {
+            cin.clear();
+            string input;
+            cin >> input;
+            if (input == "q") {
+                menus.pop();
+                return;
+            }
+        }
+        cout << "Invalid number! The number should be between 1 and 3." << endl;
+    }
+    OutputFormat formats[3] = {CSV_FORMAT, JSON_LINES_FORMAT, COLUMNAR_FORMAT};
+    ResultWriter::format = formats[op - 1];
+    cout << endl << "Output files will be written as " << ResultWriter::extension() << endl;
+    over = true;
+}
+
+/**
+ * @brief Applies a file of edits (new stations and pipes, capacity and demand changes) to the solved network one by
+ * one, updating the max flow incrementally, and writes the max flow after each edit to networkEdits.csv
+ *
+ * Complexity: O(n (V + E)) for n edits
+ */
+void networkEdits() {
+    string path;
+    getline(cin, path);
+    while (true) {
+        cout << "Enter the path of the edits file: ";
+        if (getline(cin, path)) {
+            if (path == "q") {
+                menus.pop();
+                return;
+            }
+            break;
+        }
+        else {
+            cout << "Invalid input! Please enter a valid path." << endl;
+            cin.clear();          // Clear the error state
+            cin.ignore(INT_MAX , '\n'); // Ignore the invalid input
+        }
+    }
+    cout << endl;
+
+    shared_ptr<const FlowNetwork> solved = ResultCache::solvedNetwork();
+    FlowNetwork net(*solved);
+    vector<double> before = net.getCityFlows();
+    auto start = chrono::steady_clock::now();
+    int applied = NetworkEditor::applyFile(path, net, "../outputFiles/networkEdits");
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    vector<double> after = net.getCityFlows();
+
+    cout << "City: Name, Code, Water before, Water after, Demand" << endl;
+    for (int i = 0; i < (int) csvInfo::citiesVector.size(); i++) {
+        if (before[i] == after[i]) continue;
+        cout << csvInfo::citiesVector[i].getCity() << "," << csvInfo::citiesVector[i].getCode() << "," << before[i]
+             << "," << after[i] << "," << net.getCapacity(net.getCityArc(i)) << endl;
+    }
+    cout << endl << "Edits applied: " << applied << " in " << seconds * 1000 << " ms" << endl;
+    cout << "Max flow: " << solved->getFlowValue() << " -> " << net.getFlowValue() << endl;
+    cout << endl << "Max flow after each edit written to outputFiles/networkEdits" << ResultWriter::extension() << endl;
+    over = true;
+}
+
 /**
  * @brief Checks if the city exists
  *
@@ -0,0 +1,303 @@
+#include "src/SolverTuner.h"
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+/**
+ * @brief Checks every max flow engine of SolverTuner against Edmonds Karp (FlowCore::maxFlow) on hand-made networks,
+ * on random networks (cold and warm started) and on both datasets. Exits with 1 if some engine finds a different max
+ * flow value, leaves an augmenting path or an invalid flow, or gives another split among the arcs entering the sink
+ * once made canonical (FlowCore::canonicalizeFlows). Canonical flows must also never carry water both ways between two
+ * vertices, nor put more water in the pipes than the flow of the engine did.
+ *
+ * Usage: engineCheck [projectDirectory randomNetworks], by default .. and 100000.
+ */
+
+static int failures = 0;
+
+/**
+ * @brief Checks that every arc carries between 0 and its capacity and that every vertex but the source and the sink
+ * lets out what comes in
+ *
+ * Complexity: O(V + E)
+ *
+ * @param net : Network
+ * @return True if the flow is valid
+ */
+template <class Cap>
+static bool isValidFlow(const BasicFlowNetwork<Cap> &net) {
+    vector<double> excess(net.numVertices(), 0);
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        double f = (double) net.getFlow(a);
+        if (f < -1e-6 || f > (double) net.getCapacity(a) + 1e-6 || net.getFlow(a ^ 1) != -net.getFlow(a)) return false;
+        excess[net.getHead(a)] += f;
+        excess[net.getTail(a)] -= f;
+    }
+    for (FlowId v = 0; v < net.numVertices(); v++) {
+        if (v != net.getSource() && v != net.getSink() && std::abs(excess[v]) > 1e-6) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if two opposite arcs between the same vertices, neither of them a terminal, both carry flow (e.g. the
+ * two directions of a bidirectional pipe)
+ *
+ * Complexity: O(E log E)
+ *
+ * @param net : Network
+ * @return True if water goes both ways somewhere
+ */
+template <class Cap>
+static bool carriesBothWays(const BasicFlowNetwork<Cap> &net) {
+    set<pair<FlowId, FlowId>> used;
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        FlowId u = net.getTail(a), v = net.getHead(a);
+        bool terminal = u == net.getSource() || u == net.getSink() || v == net.getSource() || v == net.getSink();
+        if ((double) net.getFlow(a) <= 1e-9 || u == v || terminal) continue;
+        if (used.count({v, u})) return true;
+        used.insert({u, v});
+    }
+    return false;
+}
+
+/**
+ * @brief Get the total flow of the arcs between vertices that are not terminals (the pipes)
+ *
+ * Complexity: O(E)
+ *
+ * @param net : Network
+ * @return Total flow
+ */
+template <class Cap>
+static double pipeFlow(const BasicFlowNetwork<Cap> &net) {
+    double total = 0;
+    for (FlowId a = 0; a < net.numArcs(); a += 2) {
+        FlowId u = net.getTail(a), v = net.getHead(a);
+        if (u != net.getSource() && u != net.getSink() && v != net.getSource() && v != net.getSink()) {
+            total += (double) net.getFlow(a);
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Solves a network with every engine and compares each one with Edmonds Karp
+ *
+ * Complexity: O(engines * solve)
+ *
+ * @param name : Name of the network, for the messages
+ * @param net : Network, with no flow or the flow to start from
+ */
+template <class Cap>
+static void checkEngines(const string &name, const BasicFlowNetwork<Cap> &net) {
+    BasicFlowNetwork<Cap> reference = net;
+    Cap expected = reference.maxFlow();
+    if (!isValidFlow(reference)) {
+        cerr << "Error: " << name << ": Edmonds Karp left a flow over a capacity or not conserved" << endl;
+        failures++;
+        return;
+    }
+    reference.canonicalizeFlows();
+    for (int e = 0; e < ENGINE_COUNT; e++) {
+        BasicFlowNetwork<Cap> copy = net;
+        Cap value = SolverTuner::solveWith(copy, (SolverEngine) e);
+        bool augmentable = copy.getSourceSide()[copy.getSink()];
+        if (std::abs((double) value - (double) expected) > 1e-6 * max(1.0, std::abs((double) expected)) || augmentable) {
+            cerr << "Error: " << name << ": the " << SolverTuner::engineName((SolverEngine) e) << " engine found "
+                 << value << " instead of " << expected << (augmentable ? " (augmenting path left)" : "") << endl;
+            failures++;
+            continue;
+        }
+        if (!isValidFlow(copy)) {
+            cerr << "Error: " << name << ": the " << SolverTuner::engineName((SolverEngine) e)
+                 << " engine left a flow over a capacity or not conserved" << endl;
+            failures++;
+            continue;
+        }
+        double raw = pipeFlow(copy);
+        copy.canonicalizeFlows();
+        double tolerance = 1e-6 * max(1.0, std::abs((double) expected));
+        bool sameValue = std::abs((double) copy.getFlowValue() - (double) expected) <= tolerance;
+        if (!sameValue || !isValidFlow(copy) || carriesBothWays(copy) || pipeFlow(copy) > raw + 1e-6 * max(1.0, raw)) {
+            cerr << "Error: " << name << ": the canonical flow of the " << SolverTuner::engineName((SolverEngine) e)
+                 << " engine is not a valid max flow, carries water both ways or puts " << pipeFlow(copy)
+                 << " in the pipes instead of " << raw << endl;
+            failures++;
+            continue;
+        }
+        for (FlowId a = 0; a < copy.numArcs(); a += 2) {
+            if (copy.getHead(a) != copy.getSink()) continue;
+            if (std::abs((double) copy.getFlow(a) - (double) reference.getFlow(a)) > 1e-6) {
+                cerr << "Error: " << name << ": the canonical flow of the " << SolverTuner::engineName((SolverEngine) e)
+                     << " engine differs on arc " << a << ", which enters the sink" << endl;
+                failures++;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reservoir -> relay -> city chain, which NetworkReduction contracts into a single source -> sink arc, next to
+ * a region that is not contracted away
+ *
+ * Complexity: O(1)
+ *
+ * @return Network
+ */
+template <class Cap>
+static BasicFlowNetwork<Cap> contractedChain() {
+    BasicFlowNetwork<Cap> net;
+    FlowId s = net.addVertex(), t = net.addVertex();
+    net.setTerminals(s, t);
+    FlowId r1 = net.addVertex(), relay = net.addVertex(), c1 = net.addVertex();
+    net.addArc(s, r1, 10);
+    net.addArc(r1, relay, 5);
+    net.addArc(relay, c1, 7);
+    net.addArc(c1, t, 6);
+
+    FlowId r2 = net.addVertex(), a = net.addVertex(), b = net.addVertex(), c2 = net.addVertex();
+    net.addArc(s, r2, 9);
+    net.addArc(r2, a, 4);
+    net.addArc(r2, b, 4);
+    net.addArc(a, b, 2);
+    net.addArc(a, c2, 3);
+    net.addArc(b, c2, 5);
+    net.addArc(c2, t, 8);
+    return net;
+}
+
+/**
+ * @brief Random network with parallel arcs, self loops, arcs into the source or out of the sink, zero capacities and
+ * direct source -> sink arcs. Half of them are warm started: solved, then with some capacities lowered.
+ *
+ * Complexity: O(V + E), O(V E^2) when warm started
+ *
+ * @param rng : Random numbers
+ * @param fractional : Whether capacities may have decimals (only for double)
+ * @return Network
+ */
+template <class Cap>
+static BasicFlowNetwork<Cap> randomNetwork(mt19937 &rng, bool fractional) {
+    BasicFlowNetwork<Cap> net;
+    int n = 2 + (int) (rng() % 30);
+    for (int i = 0; i < n; i++) net.addVertex();
+    net.setTerminals(0, n - 1);
+    int m = (int) (rng() % (4 * n + 1));
+    for (int i = 0; i < m; i++) {
+        Cap cap = fractional ? (Cap) (rng() % 2000) / 100 : (Cap) (rng() % 20);
+        net.addArc(rng() % n, rng() % n, cap);
+    }
+    if (rng() % 2 == 0) {
+        net.maxFlow();
+        for (FlowId a = 0; a < net.numArcs(); a += 2) {
+            if (rng() % 5 == 0) net.setCapacity(a, net.getCapacity(a) / 2);
+        }
+    }
+    return net;
+}
+
+/**
+ * @brief Reads the first fields of a csv line
+ *
+ * Complexity: O(line)
+ *
+ * @param line : Line
+ * @param count : Number of fields
+ * @return Fields (empty strings for missing ones)
+ */
+static vector<string> fields(const string &line, int count) {
+    vector<string> res(count);
+    stringstream s(line);
+    for (int i = 0; i < count; i++) getline(s, res[i], ',');
+    return res;
+}
+
+/**
+ * @brief Builds the network of a dataset straight from its files, like FlowNetwork::fromPipesGraph but without
+ * csvInfo (which only loads the large dataset)
+ *
+ * Complexity: O(V + E)
+ *
+ * @param reservoirsPath : Reservoirs file
+ * @param citiesPath : Cities file
+ * @param pipesPath : Pipes file
+ * @param net : Network (output)
+ * @return True if the three files were read
+ */
+template <class Cap>
+static bool datasetNetwork(const string &reservoirsPath, const string &citiesPath, const string &pipesPath,
+                           BasicFlowNetwork<Cap> &net) {
+    ifstream reservoirs(reservoirsPath), cities(citiesPath), pipes(pipesPath);
+    if (!reservoirs.is_open() || !cities.is_open() || !pipes.is_open()) {
+        cerr << "Error: Unable to open the files of " << pipesPath << "." << endl;
+        return false;
+    }
+    map<string, FlowId> ids;
+    auto vertex = [&](const string &code) {
+        auto it = ids.find(code);
+        if (it != ids.end()) return it->second;
+        return ids[code] = net.addVertex();
+    };
+    FlowId s = net.addVertex(), t = net.addVertex();
+    net.setTerminals(s, t);
+
+    string line;
+    getline(reservoirs, line);    // discard header line
+    while (getline(reservoirs, line)) {
+        vector<string> f = fields(line, 5);
+        if (!f[3].empty()) net.addArc(s, vertex(f[3]), (Cap) stod(f[4]));
+    }
+    getline(cities, line);    // discard header line
+    while (getline(cities, line)) {
+        vector<string> f = fields(line, 4);
+        if (!f[2].empty()) net.addArc(vertex(f[2]), t, (Cap) stod(f[3]));
+    }
+    getline(pipes, line);    // discard header line
+    while (getline(pipes, line)) {
+        vector<string> f = fields(line, 4);
+        if (f[0].empty()) continue;
+        net.addArc(vertex(f[0]), vertex(f[1]), (Cap) stod(f[2]));
+        if (stoi(f[3]) == 0) net.addArc(vertex(f[1]), vertex(f[0]), (Cap) stod(f[2]));
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    string project = argc > 1 ? argv[1] : "..";
+    int randomNetworks = argc > 2 ? atoi(argv[2]) : 100000;
+
+    checkEngines("contracted chain", contractedChain<int32_t>());
+    checkEngines("contracted chain", contractedChain<double>());
+
+    mt19937 rng(2024);
+    for (int i = 0; i < randomNetworks; i++) {
+        string name = "random network " + to_string(i);
+        if (i % 4 == 3) checkEngines(name, randomNetwork<double>(rng, true));
+        else checkEngines(name, randomNetwork<int32_t>(rng, false));
+    }
+
+    string datasets[2][3] = {{"/Project1LargeDataSet/Reservoir.csv", "/Project1LargeDataSet/Cities.csv",
+                              "/Project1LargeDataSet/Pipes.csv"},
+                             {"/Project1DataSetSmall/Reservoirs_Madeira.csv", "/Project1DataSetSmall/Cities_Madeira.csv",
+                              "/Project1DataSetSmall/Pipes_Madeira.csv"}};
+    for (auto &files : datasets) {
+        BasicFlowNetwork<double> net;
+        if (!datasetNetwork(project + files[0], project + files[1], project + files[2], net)) {
+            failures++;
+            continue;
+        }
+        checkEngines(files[2], net);
+        checkEngines(files[2], BasicFlowNetwork<int64_t>(net));
+    }
+
+    if (failures > 0) {
+        cerr << failures << " engine checks failed" << endl;
+        return 1;
+    }
+    cout << "Every engine agrees with Edmonds Karp on " << randomNetworks << " random networks and both datasets" << endl;
+    return 0;
+}